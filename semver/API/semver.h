@@ -42,19 +42,24 @@ extern "C" // for rest of file
 	static const uint64_t SEMVER_WILDCARD_IDENTIFIER = 0xFEED'FEED'FEED'FEED; // attempting to parse with a wildcard will return this value for major, minor or patch.
 
     // builds are pre-releases are "labels"
-	static const char SEMVER_UNINITIALIZED_LABEL[] = "?";
-	static const char SEMVER_EMPTY_LABEL[] = "";
+	static constexpr char SEMVER_UNINITIALIZED_LABEL[] = "?";
+	static constexpr char SEMVER_EMPTY_LABEL[] = "";
 
-	static const char SEMVER_LOWEST_PRERELEASE[] = "0";
+	static constexpr char SEMVER_LOWEST_PRERELEASE[] = "0";
 
 	typedef struct SemverVersionImpl* HSemverVersion; // transparent handle for a version object
 	
 	typedef struct SemverVersionsImpl* HSemverVersions; // transparent proto handle for a Version block in or a subset or ordered set from that block
 
 
+	typedef struct SemverVersionsStreamImpl* HSemverVersionsStream; // transparent handle for a Version block being parsed from chunks
+
 	typedef struct SemverQueryImpl* HSemverQuery; // transparent handle for a version query (a set of 1 or more ranges)
 	typedef struct SemverRangeImpl* HSemverRange; // transparent handle for a range (a query has 1 or more ranges)
 	typedef struct SemverBoundImpl* HSemverBound; // transparent handle for a bound (upper or lower bound in a range)
+	typedef struct SemverResolverImpl* HSemverResolver; // transparent handle for a dependency resolver over packages with version arrays
+	typedef struct SemverQueryIndexImpl* HSemverQueryIndex; // transparent handle for an index of many queries, to find those matching a version
+	typedef struct SemverQueryWatchImpl* HSemverQueryWatch; // transparent handle for the highest versions many queries matched in a stream of versions
 
 
 	enum SemverParseResult : uint8_t 
@@ -131,6 +136,14 @@ extern "C" // for rest of file
 	};
 
 
+	enum SemverDedup : uint8_t
+	{
+		SEMVER_DEDUP_NONE,
+		SEMVER_DEDUP_PRECEDENCE, // versions with equal precedence are kept once (builds are ignored)
+		SEMVER_DEDUP_PRECEDENCE_AND_BUILD, // only versions with equal precedence and equal build are dropped
+	};
+
+
 	// version constructors
 	///////////////////////
 
@@ -150,6 +163,42 @@ extern "C" // for rest of file
 
 	SEMVER_API HSemverVersions semver_versions_create(size_t count);
 
+	// new block with copies of the versions of all arrays. Arrays already sorted in order (or the reverse) are merged in linear time,
+	// others are sorted first. SEMVER_ORDER_AS_GIVEN concatenates. Of duplicates the first (from the earliest array) is kept
+	SEMVER_API HSemverVersions semver_versions_merge(const HSemverVersions* version_arrays, size_t array_count, SemverOrder order, SemverDedup dedup);
+
+	// view of the versions of version_array without duplicates, first occurrences kept. Disposed with version_array, or separately.
+	// For a compact owning copy, merge the single array
+	SEMVER_API HSemverVersions semver_versions_unique(const HSemverVersions version_array, SemverDedup dedup);
+
+	// large arrays (2 MB and up) can be mapped on their own pages: backed by transparent huge pages, so binary searches
+	// over them miss the TLB less, and bound to a NUMA node. Applies to fixed-size arrays created afterwards. Linux only,
+	// elsewhere the options are ignored. Set it while no arrays are being created
+	typedef struct SemverAllocation
+	{
+		BOOL huge_pages;
+		int numa_node; // -1 for the policy of the allocating thread
+	} SemverAllocation;
+
+	SEMVER_API void semver_versions_set_allocation(const SemverAllocation* allocation); // NULL for the heap, as by default
+	SEMVER_API int semver_current_numa_node(); // of the calling thread, -1 if not known
+
+	// owning copy of version_array (keeping its order) placed on numa_node, so read-mostly arrays can be searched from
+	// a replica on the node of each thread. Huge pages as set with semver_versions_set_allocation
+	SEMVER_API HSemverVersions semver_versions_replicate(const HSemverVersions version_array, int numa_node);
+
+	// blocks that can be appended to. Sorted blocks (ASC/DESC) keep their order on append, which shifts the pointers
+	// after the insertion point: O(n) per append, constant when versions arrive in order. Bulk load with semver_versions_from_string.
+	// Versions never move, so versions and reference blocks taken from the block remain valid as it grows
+	SEMVER_API HSemverVersions semver_versions_create_growable(size_t capacity, SemverOrder order);
+	SEMVER_API HSemverVersion semver_versions_append(HSemverVersions version_array, const char* version_str); // NULL if the block is not growable
+
+	// incremental semver_versions_from_string for input that arrives in chunks. Tokens may be split across chunks.
+	// finish returns the block and disposes the stream handle
+	SEMVER_API HSemverVersionsStream semver_versions_stream_begin(const char* separator);
+	SEMVER_API void semver_versions_stream_feed(HSemverVersionsStream stream, const char* buf, size_t len);
+	SEMVER_API HSemverVersions semver_versions_stream_finish(HSemverVersionsStream stream, SemverOrder order);
+
 	// query constructor
 	////////////////////
 
@@ -177,6 +226,10 @@ extern "C" // for rest of file
 	SEMVER_API size_t semver_versions_count(HSemverVersions version_array);
 	SEMVER_API HSemverVersion semver_versions_get_version_at_index(HSemverVersions version_array, size_t index);
 
+	// writes all version strings joined by separator into buf, same contract as semver_version_format. 
+	// A NULL or empty separator writes each version \0 terminated (readable by semver_versions_from_string)
+	SEMVER_API size_t semver_versions_format(const HSemverVersions version_array, const char* separator, char* buf, size_t cap);
+
 	// version info
 	///////////////
 
@@ -186,7 +239,11 @@ extern "C" // for rest of file
 	SEMVER_API const char* semver_get_version_prerelease(const HSemverVersion version); // no need to dispose char*, disposed by HSemverVersion in semver_version_dispose
 	SEMVER_API const char* semver_get_version_build(const HSemverVersion version); // no need to dispose char*, disposed by HSemverVersion in semver_version_dispose
 
-	SEMVER_API char* semver_get_version_string(const HSemverVersion version); // \0 terminated string, freed with semver_free_version_string
+	SEMVER_API char* semver_get_version_string(const HSemverVersion version); // \0 terminated string, freed with semver_free_string
+
+	// writes the version string into buf (truncated and \0 terminated if it does not fit, buf may be NULL if cap is 0)
+	// returns the length of the full string excluding the \0, so the string fit if the result is less than cap
+	SEMVER_API size_t semver_version_format(const HSemverVersion version, char* buf, size_t cap);
 
 	// version/query string destructor
 	////////////////////////////
@@ -281,11 +338,132 @@ extern "C" // for rest of file
 	SEMVER_API BOOL semver_query_matches_version(const HSemverQuery query, const HSemverVersion version);
 
 	SEMVER_API HSemverVersions semver_query_match_versions(const HSemverQuery query, const HSemverVersions versions);
+	// matches from offset on, at most limit of them, in order (SEMVER_ORDER_AS_GIVEN for the order of the array). Sorted
+	// arrays are walked in that order and only where the ranges of the query are, stopping at limit matches
+	SEMVER_API HSemverVersions semver_query_match_versions_limit(const HSemverQuery query, const HSemverVersions versions, size_t offset, size_t limit, SemverOrder order);
+
+	// walks the matches one at a time in the order of the array, without allocating. The cursor lives wherever the caller
+	// puts it; the query and the array must outlive it and not change while it walks
+	typedef struct SemverMatchCursor
+	{
+		HSemverQuery query;
+		HSemverVersions versions;
+		size_t next; // position to check next
+		size_t end; // end of the positions the query can match from next on
+	} SemverMatchCursor;
+
+	typedef SemverMatchCursor* HSemverMatchCursor;
+
+	SEMVER_API void semver_match_cursor_init(HSemverMatchCursor cursor, const HSemverQuery query, const HSemverVersions versions);
+	SEMVER_API HSemverVersion semver_match_cursor_next(HSemverMatchCursor cursor); // NULL after the last match
+
+	// matches every query against the array in one pass. match_bits receives a row of SEMVER_MATCH_BITS_WORDS(count) words per query,
+	// where bit i (of word i / 64) is set if the query matches the version at index i
+	#define SEMVER_MATCH_BITS_WORDS(version_count) (((version_count) + 63) / 64)
+	SEMVER_API void semver_queries_match_versions(const HSemverQuery* queries, size_t query_count, const HSemverVersions versions, uint64_t* match_bits);
+
+	// indexes where each major and major.minor start in a sorted array, so matching searches within a single major.minor.
+	// FALSE for unsorted or empty arrays. Appending drops the index; index again after editing versions in the array
+	SEMVER_API BOOL semver_versions_index(HSemverVersions version_array);
 	SEMVER_API HSemverVersion semver_query_highest_match(const HSemverQuery query, const HSemverVersions versions);
 
+	// query algebra, computed on the ranges without enumerating versions. New queries are disposed with semver_query_dispose
+	SEMVER_API HSemverQuery semver_query_intersect(const HSemverQuery lhs, const HSemverQuery rhs); // versions both match
+	SEMVER_API HSemverQuery semver_query_union(const HSemverQuery lhs, const HSemverQuery rhs); // versions either matches
+	SEMVER_API HSemverQuery semver_query_complement(const HSemverQuery query); // stable versions query does not match
+	SEMVER_API BOOL semver_query_is_subset(const HSemverQuery lhs, const HSemverQuery rhs); // rhs matches every version lhs matches
+	SEMVER_API BOOL semver_query_is_disjoint(const HSemverQuery lhs, const HSemverQuery rhs); // no version matches both
+
+	// query index: finds which of many queries match a version. Queries are copied, ids need not be unique
+	SEMVER_API HSemverQueryIndex semver_query_index_create();
+	SEMVER_API void semver_query_index_add(HSemverQueryIndex index, const HSemverQuery query, uint64_t id);
+	SEMVER_API BOOL semver_query_index_remove(HSemverQueryIndex index, uint64_t id); // removes all queries added with id
+	// writes up to cap ids (ascending, each once) of queries matching version, returns the total number of matching ids
+	SEMVER_API size_t semver_query_index_match(HSemverQueryIndex index, const HSemverVersion version, uint64_t* ids, size_t cap);
+	SEMVER_API void semver_query_index_dispose(HSemverQueryIndex index);
+
+	// query watch: keeps the highest match of many queries as versions arrive one at a time. Queries are copied, queries
+	// added with the same id share their best match. Queries only see versions pushed after they were added
+	SEMVER_API HSemverQueryWatch semver_query_watch_create();
+	SEMVER_API void semver_query_watch_add(HSemverQueryWatch watch, const HSemverQuery query, uint64_t id);
+	SEMVER_API BOOL semver_query_watch_remove(HSemverQueryWatch watch, uint64_t id); // removes all queries added with id
+	// writes up to cap ids (ascending, each once) whose best match is now version, returns the total number of such ids
+	SEMVER_API size_t semver_query_watch_push(HSemverQueryWatch watch, const HSemverVersion version, uint64_t* ids, size_t cap);
+	SEMVER_API HSemverVersion semver_query_watch_best(const HSemverQueryWatch watch, uint64_t id); // NULL until a version matched, owned by the watch
+	SEMVER_API void semver_query_watch_dispose(HSemverQueryWatch watch);
+
+	// dependency resolver: selects one version per package so that all dependencies of selected versions are met
+	SEMVER_API HSemverResolver semver_resolver_create();
+	// the version array is referenced, keep it until the resolver is disposed. FALSE if the product was already added
+	SEMVER_API BOOL semver_resolver_add_package(HSemverResolver resolver, const char* product, const HSemverVersions versions);
+	// the version at version_index (in the product's array) depends on a version of dependency matching query. FALSE for unknown products,
+	// versions out of range or a NULL query
+	SEMVER_API BOOL semver_resolver_add_dependency(HSemverResolver resolver, const char* product, size_t version_index, const char* dependency, const HSemverQuery query);
+	SEMVER_API void semver_resolver_require(HSemverResolver resolver, const char* product, const HSemverQuery query); // top level requirement, none for a NULL query
+	SEMVER_API BOOL semver_resolver_solve(HSemverResolver resolver); // prefers the highest versions. FALSE if no selection meets all requirements
+	SEMVER_API size_t semver_resolver_selected_count(const HSemverResolver resolver);
+	SEMVER_API const char* semver_resolver_selected_product_at_index(const HSemverResolver resolver, size_t index);
+	SEMVER_API HSemverVersion semver_resolver_selected_version_at_index(const HSemverResolver resolver, size_t index);
+	SEMVER_API HSemverVersion semver_resolver_get_selected(const HSemverResolver resolver, const char* product); // NULL if not selected
+	// explains why the last solve failed, one derivation per line (snprintf semantics, returns the length needed)
+	SEMVER_API size_t semver_resolver_format_conflict(const HSemverResolver resolver, char* buf, size_t cap);
+	SEMVER_API void semver_resolver_dispose(HSemverResolver resolver);
+
 	// Query check methods
 	///////////////////////
 
-	SEMVER_API const char* semver_get_query_string(const HSemverQuery query); // \0 terminated string, freed when HSemverVersion handle is disposed
+	SEMVER_API const char* semver_get_query_string(const HSemverQuery query); // \0 terminated string, freed with semver_free_string
+
+	SEMVER_API size_t semver_query_format(const HSemverQuery query, char* buf, size_t cap); // same contract as semver_version_format
+
+	// Statistics
+	/////////////
+
+	// work done by the library, summed over all threads since the last reset. Only collected when the library is
+	// built with SEMVER_ENABLE_STATS, counting costs a thread local increment on each counted call
+	typedef struct SemverStats
+	{
+		uint64_t version_parses; // versions and query junctures
+		uint64_t prerelease_heap_spills; // prereleases and minimum prereleases too long to keep inline
+		uint64_t build_map_inserts;
+		uint64_t version_compares;
+		uint64_t prerelease_compares; // compares of equal cores that fall back to comparing prereleases
+		uint64_t query_matches;
+		uint64_t blocks_created; // version arrays, including sorted and filtered references
+		uint64_t block_sorts;
+		uint64_t block_queries; // queries matched against a version array (match, highest match, multiple queries)
+	} SemverStats;
+
+	SEMVER_API BOOL semver_stats_snapshot(SemverStats* stats); // FALSE (and all zero) if stats are not collected
+	SEMVER_API void semver_stats_reset();
+
+	// Tracing
+	//////////
+
+	enum SemverTracePhase : uint8_t
+	{
+		SEMVER_TRACE_SPLIT, // a buffer into version strings
+		SEMVER_TRACE_PARSE, // version strings into a version array
+		SEMVER_TRACE_SORT,
+		SEMVER_TRACE_MATCH, // queries against a version array
+	};
+
+	typedef struct SemverTraceEvent
+	{
+		SemverTracePhase phase;
+		BOOL begin; // FALSE for the end of the phase
+		uint64_t items; // begin: items going in (0 if not known yet), end: items coming out (strings, versions, matches)
+		uint64_t bytes; // text processed, 0 for phases without text
+	} SemverTraceEvent;
+
+	typedef void (*SemverTraceCallback)(void* context, const SemverTraceEvent* event);
+
+	// traces the bulk operations on version arrays, on the threads calling them. NULL turns tracing off, which costs
+	// a load per phase. Set it while no traced calls are running
+	SEMVER_API void semver_trace_set_callback(SemverTraceCallback callback, void* context);
+
+	// a callback writing Chrome trace events (JSON, see chrome://tracing or Perfetto) to a file until the trace ends
+	SEMVER_API BOOL semver_trace_chrome_begin(const char* path); // FALSE if the file can not be created
+	SEMVER_API void semver_trace_chrome_end(); // turns tracing off and completes the file
 
 }
\ No newline at end of file
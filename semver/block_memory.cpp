@@ -0,0 +1,96 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "block_memory.h"
+#include <cstdint>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace semver
+{
+	namespace memory
+	{
+		static constexpr size_t sPrefix = 64; // holds the length of the mapping, keeps the block on a cache line
+
+#ifdef __linux__
+		static uintptr_t roundUp(uintptr_t n, size_t multiple) { return (n + multiple - 1) / multiple * multiple; }
+
+		// mbind without libnuma. The kernel reads maxNodes bits of the mask, one more is passed for its off by one
+		static void bindToNode(void* start, size_t length, int node)
+		{
+			constexpr int mpolBind = 2; // MPOL_BIND
+			constexpr size_t maxNodes = 1024;
+			constexpr size_t bitsPerWord = 8 * sizeof(unsigned long);
+
+			if (static_cast<size_t>(node) >= maxNodes)
+				return;
+
+			unsigned long mask[maxNodes / bitsPerWord] = {};
+			mask[node / bitsPerWord] = 1UL << (node % bitsPerWord);
+
+			syscall(SYS_mbind, start, length, mpolBind, mask, maxNodes + 1, 0); // not fatal, the pages are placed as usual
+		}
+#endif
+
+		void* allocateMapped(size_t bytes, bool hugePages, int numaNode)
+		{
+#ifdef __linux__
+			size_t length = roundUp(bytes + sPrefix, hugePageSize);
+			size_t reserved = length + hugePageSize; // room to move the start to a huge page boundary
+
+			char* raw = static_cast<char*>(mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+			if (raw == MAP_FAILED)
+				return nullptr;
+
+			char* start = reinterpret_cast<char*>(roundUp(reinterpret_cast<uintptr_t>(raw), hugePageSize));
+			size_t head = start - raw;
+
+			if (head > 0)
+				munmap(raw, head);
+
+			if (reserved - head > length)
+				munmap(start + length, reserved - head - length);
+
+			if (hugePages)
+				madvise(start, length, MADV_HUGEPAGE); // fails quietly where transparent huge pages are disabled
+
+			if (numaNode >= 0)
+				bindToNode(start, length, numaNode);
+
+			*reinterpret_cast<size_t*>(start) = length;
+			return start + sPrefix;
+#else
+			(void)bytes;
+			(void)hugePages;
+			(void)numaNode;
+			return nullptr;
+#endif
+		}
+
+		void freeMapped(void* memory)
+		{
+#ifdef __linux__
+			char* start = static_cast<char*>(memory) - sPrefix;
+			munmap(start, *reinterpret_cast<size_t*>(start));
+#else
+			(void)memory;
+#endif
+		}
+
+		int currentNode()
+		{
+#ifdef __linux__
+			unsigned cpu = 0;
+			unsigned node = 0;
+
+			if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+				return static_cast<int>(node);
+#endif
+			return -1;
+		}
+	}
+}
@@ -0,0 +1,21 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include <cstddef>
+
+namespace semver
+{
+	namespace memory
+	{
+		constexpr size_t hugePageSize = size_t(2) << 20;
+		constexpr size_t minMappedSize = hugePageSize; // smaller blocks come from the heap, which pages can't be bound in
+
+		// pages mapped for a single large block, aligned to hugePageSize. With hugePages the kernel is asked to back them
+		// with transparent huge pages, with numaNode >= 0 they are bound to that node before they are touched. Both are
+		// best effort. nullptr where mapping is not supported (Linux only), the caller falls back to the heap
+		void* allocateMapped(size_t bytes, bool hugePages, int numaNode);
+		void freeMapped(void* memory); // from allocateMapped
+
+		int currentNode(); // of the calling thread, -1 if not known
+	}
+}
@@ -0,0 +1,108 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include "range.h"
+#include <utility>
+
+namespace semver
+{
+	// Versions and queries parsed at compile time, for constraints fixed in the binary (e.g. ">=3.4 <4"_svq).
+	// Each literal is a constant with static storage: nothing is parsed or allocated at run time, and nothing
+	// is disposed. Prereleases and minimum prereleases must fit inline, and static versions have no builds
+
+	template <size_t N>
+	struct FixedString // a string literal as a template argument
+	{
+		char str[N];
+
+		constexpr FixedString(const char (&literal)[N]) { std::copy_n(literal, N, str); }
+		constexpr size_t size() const { return N - 1; }
+	};
+
+	struct StaticVersion
+	{
+		Version version;
+		SemverParseResult result;
+	};
+
+	// literals are parsed from copies: the null checks of the parser do not fold on template arguments with some sanitizers
+
+	template <size_t L>
+	constexpr StaticVersion parseStaticVersion(FixedString<L> literal)
+	{
+		StaticVersion parsed{ Version{ 0, 0, 0, Version::MANAGED }, SEMVER_PARSE_SUCCESS };
+		parsed.result = parsed.version.parseIgnoreBuild(literal.str, literal.size());
+		return parsed;
+	}
+
+	template <size_t N>
+	struct StaticQuery
+	{
+		Range ranges[N]; // minimum prereleases are inline, a longer one is not a constant expression
+		SemverQueryParseResult result;
+
+		constexpr size_t size() const { return N; }
+		constexpr const Range* begin() const { return ranges; }
+		constexpr const Range* end() const { return ranges + N; }
+
+		constexpr bool matches(const Version& version) const
+		{
+			for (const Range& r : ranges)
+				if (r.matches(version))
+					return true;
+
+			return false;
+		}
+	};
+
+	template <size_t L>
+	constexpr size_t countStaticRanges(FixedString<L> literal)
+	{
+		RangeSet ranges;
+		ranges.parse(literal.str, literal.size());
+		return ranges.empty() ? 1 : ranges.size(); // failed parses are reported, not stored
+	}
+
+	template <size_t N, size_t... I>
+	constexpr StaticQuery<N> makeStaticQuery(const RangeSet& ranges, SemverQueryParseResult result, std::index_sequence<I...>)
+	{
+		return { { ranges[I]... }, result };
+	}
+
+	template <size_t N, size_t L>
+	constexpr StaticQuery<N> parseStaticQuery(FixedString<L> literal)
+	{
+		RangeSet ranges;
+		SemverQueryParseResult result = ranges.parse(literal.str, literal.size());
+
+		if (ranges.empty())
+			ranges.emplace_back(); // keeps a failed parse constant, the result reports it
+
+		return makeStaticQuery<N>(ranges, result, std::make_index_sequence<N>());
+	}
+
+	template <FixedString S>
+	inline constexpr StaticVersion sStaticVersion = parseStaticVersion(S);
+
+	template <FixedString S>
+	inline constexpr StaticQuery<countStaticRanges(S)> sStaticQuery = parseStaticQuery<countStaticRanges(S)>(S);
+
+	namespace literals
+	{
+		template <FixedString S>
+		constexpr const Version& operator""_sv()
+		{
+			static_assert(getCharPosEx('+', S.str, S.size(), 0) == S.size(), "static versions can not have builds");
+			static_assert(sStaticVersion<S>.result == SEMVER_PARSE_SUCCESS, "invalid version");
+			return sStaticVersion<S>.version;
+		}
+
+		template <FixedString S>
+		constexpr const auto& operator""_svq()
+		{
+			static_assert(sStaticQuery<S>.result == SEMVER_QUERY_PARSE_SUCCESS, "invalid query");
+			return sStaticQuery<S>;
+		}
+	}
+
+}
@@ -0,0 +1,183 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "query_index.h"
+#include <algorithm>
+
+namespace semver
+{
+
+	void QueryIndex::add(const Query& query, uint64_t id)
+	{
+		for (const Range& r : query.rangeSet)
+		{
+			if (Version::compare(r.lower.juncture, r.upper.juncture) > 0)
+				continue; // matches nothing
+
+			entries.push_back({ r.clone(), id });
+		}
+
+		dirty = true;
+	}
+
+	size_t QueryIndex::remove(uint64_t id)
+	{
+		auto removed = std::partition(entries.begin(), entries.end(), [id](const Entry& e) { return e.id != id; });
+
+		for (auto it = removed; it != entries.end(); ++it)
+			it->range.deleteHeapResources();
+
+		size_t count = entries.end() - removed;
+		entries.erase(removed, entries.end());
+		dirty |= count != 0;
+
+		return count;
+	}
+
+	QueryIndex::~QueryIndex()
+	{
+		for (Entry& e : entries)
+			e.range.deleteHeapResources();
+	}
+
+	void QueryIndex::build()
+	{
+		nodes.clear();
+
+		std::vector<uint32_t> all(entries.size());
+
+		for (uint32_t i = 0; i < all.size(); ++i)
+			all[i] = i;
+
+		root = buildNode(all);
+		dirty = false;
+	}
+
+	int32_t QueryIndex::buildNode(std::vector<uint32_t>& entryIndices)
+	{
+		if (entryIndices.empty())
+			return -1;
+
+		std::vector<const Version*> junctures; // the median bound splits the entries roughly in half
+		junctures.reserve(entryIndices.size() * 2);
+
+		for (uint32_t i : entryIndices)
+		{
+			junctures.push_back(&entries[i].range.lower.juncture);
+			junctures.push_back(&entries[i].range.upper.juncture);
+		}
+
+		auto median = junctures.begin() + junctures.size() / 2;
+		std::nth_element(junctures.begin(), median, junctures.end(), [](const Version* a, const Version* b) { return *a < *b; });
+
+		Node node;
+		node.center = *median;
+
+		std::vector<uint32_t> below;
+		std::vector<uint32_t> above;
+
+		for (uint32_t i : entryIndices)
+		{
+			const Range& r = entries[i].range;
+
+			if (Version::compare(r.upper.juncture, *node.center) < 0)
+				below.push_back(i);
+			else if (Version::compare(r.lower.juncture, *node.center) > 0)
+				above.push_back(i);
+			else
+				node.byLower.push_back(i); // the entry of the center itself lands here, so every node takes at least one
+		}
+
+		node.byUpper = node.byLower;
+
+		std::sort(node.byLower.begin(), node.byLower.end(), [this](uint32_t a, uint32_t b) // the included bound admits more
+			{
+				const Bound& x = entries[a].range.lower;
+				const Bound& y = entries[b].range.lower;
+				int comp = Version::compare(x.juncture, y.juncture);
+				return comp < 0 || (comp == 0 && x.isIncluded() && !y.isIncluded());
+			});
+
+		std::sort(node.byUpper.begin(), node.byUpper.end(), [this](uint32_t a, uint32_t b)
+			{
+				const Bound& x = entries[a].range.upper;
+				const Bound& y = entries[b].range.upper;
+				int comp = Version::compare(x.juncture, y.juncture);
+				return comp > 0 || (comp == 0 && x.isIncluded() && !y.isIncluded());
+			});
+
+		int32_t index = static_cast<int32_t>(nodes.size());
+		nodes.push_back(std::move(node));
+
+		entryIndices.clear(); // no longer needed, release before recursing
+		entryIndices.shrink_to_fit();
+
+		int32_t left = buildNode(below);
+		int32_t right = buildNode(above);
+		nodes[index].left = left;
+		nodes[index].right = right;
+
+		return index;
+	}
+
+	void QueryIndex::match(const Version& version, std::vector<uint64_t>& ids)
+	{
+		ids.clear();
+
+		if (!version.isDefined())
+			return;
+
+		if (dirty)
+			build();
+
+		bool isPrerelease = version.isPrerelease();
+
+		auto add = [&](uint32_t i)
+			{
+				if (!isPrerelease || entries[i].range.matches(version)) // prereleases have extra conditions
+					ids.push_back(entries[i].id);
+			};
+
+		for (int32_t n = root; n != -1; )
+		{
+			const Node& node = nodes[n];
+			int comp = Version::compare(version, *node.center);
+
+			if (comp < 0) // upper bounds are all above the version
+			{
+				for (uint32_t i : node.byLower)
+				{
+					if (!entries[i].range.lowerAdmits(version))
+						break;
+
+					add(i);
+				}
+
+				n = node.left;
+			}
+			else if (comp > 0) // lower bounds are all below the version
+			{
+				for (uint32_t i : node.byUpper)
+				{
+					if (!entries[i].range.upperAdmits(version))
+						break;
+
+					add(i);
+				}
+
+				n = node.right;
+			}
+			else
+			{
+				for (uint32_t i : node.byLower)
+					if (entries[i].range.lowerAdmits(version) && entries[i].range.upperAdmits(version))
+						add(i);
+
+				break;
+			}
+		}
+
+		std::sort(ids.begin(), ids.end()); // queries with several matching ranges are listed once
+		ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	}
+
+}
@@ -0,0 +1,51 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include "range.h"
+#include <vector>
+
+namespace semver
+{
+	// Finds the queries that match a version, without matching every query. Ranges are kept in a centered interval
+	// tree: each node holds the ranges whose bounds enclose its center, sorted by lower and by upper bound,
+	// so a lookup visits O(log n) nodes and stops scanning a node at the first range that does not admit the version
+	struct QueryIndex
+	{
+		struct Entry
+		{
+			Range range; // deep copy, the index owns its prerelease
+			uint64_t id;
+		};
+
+		void add(const Query& query, uint64_t id);
+		size_t remove(uint64_t id); // returns the number of ranges removed
+		void match(const Version& version, std::vector<uint64_t>& ids); // ids of matching queries, ascending and unique
+
+		size_t rangeCount() const { return entries.size(); }
+
+		QueryIndex() = default;
+		QueryIndex(const QueryIndex&) = delete;
+		QueryIndex& operator=(const QueryIndex&) = delete;
+		~QueryIndex();
+
+	private:
+
+		struct Node
+		{
+			const Version* center; // a bound juncture of one of the entries
+			std::vector<uint32_t> byLower; // entries enclosing center, ascending lower bound
+			std::vector<uint32_t> byUpper; // entries enclosing center, descending upper bound
+			int32_t left = -1; // node for entries entirely below center
+			int32_t right = -1; // node for entries entirely above center
+		};
+
+		std::vector<Entry> entries;
+		std::vector<Node> nodes;
+		int32_t root = -1;
+		bool dirty = false; // rebuilt on the next match after adding or removing
+
+		void build();
+		int32_t buildNode(std::vector<uint32_t>& entryIndices);
+	};
+
+}
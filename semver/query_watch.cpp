@@ -0,0 +1,57 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "query_watch.h"
+
+namespace semver
+{
+
+	void QueryWatch::add(const Query& query, uint64_t id)
+	{
+		index.add(query, id);
+	}
+
+	size_t QueryWatch::remove(uint64_t id)
+	{
+		auto it = bests.find(id);
+
+		if (it != bests.end())
+		{
+			it->second.deleteHeapResources();
+			bests.erase(it);
+		}
+
+		return index.remove(id);
+	}
+
+	void QueryWatch::push(const Version& version, std::vector<uint64_t>& changed)
+	{
+		changed.clear();
+		index.match(version, matched);
+
+		for (uint64_t id : matched)
+		{
+			auto [it, first] = bests.try_emplace(id);
+			Version& best = it->second;
+
+			if (!first && Version::compare(version, best) <= 0)
+				continue; // equal precedence is not a change, even with another build
+
+			best.copyFrom(version);
+			best.flags |= Version::MANAGED; // handles to it are not disposed by the caller
+			changed.push_back(id);
+		}
+	}
+
+	const Version* QueryWatch::best(uint64_t id) const
+	{
+		auto it = bests.find(id);
+		return it == bests.end() ? nullptr : &it->second;
+	}
+
+	QueryWatch::~QueryWatch()
+	{
+		for (auto& [id, best] : bests)
+			best.deleteHeapResources();
+	}
+
+}
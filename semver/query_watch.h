@@ -0,0 +1,32 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include "query_index.h"
+#include <unordered_map>
+#include <vector>
+
+namespace semver
+{
+	// Keeps the highest version each watched query has matched, for versions that arrive one at a time. The
+	// queries are kept in a QueryIndex, so a version costs a lookup plus one compare per matching subscription
+	// rather than a match of every query, and no earlier versions are kept to match again
+	struct QueryWatch
+	{
+		void add(const Query& query, uint64_t id); // queries added with the same id share their best match
+		size_t remove(uint64_t id); // returns the number of ranges removed, the best match is forgotten
+		void push(const Version& version, std::vector<uint64_t>& changed); // ids whose best match is now version, ascending
+		const Version* best(uint64_t id) const; // nullptr until a version matched
+
+		QueryWatch() = default;
+		QueryWatch(const QueryWatch&) = delete;
+		QueryWatch& operator=(const QueryWatch&) = delete;
+		~QueryWatch();
+
+	private:
+
+		QueryIndex index;
+		std::vector<uint64_t> matched; // reused between pushes
+		std::unordered_map<uint64_t, Version> bests; // nodes keep their address, builds are stored by address
+	};
+
+}
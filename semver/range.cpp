@@ -10,53 +10,6 @@ namespace semver
     static const Bound sMaxBound = Bound{ Version{SEMVER_MAX_NUMERIC_IDENTIFIER, SEMVER_MAX_NUMERIC_IDENTIFIER, SEMVER_MAX_NUMERIC_IDENTIFIER, Version::MANAGED},
          Bound::Included::YES, Bound::MatchPreReleases::NO };
 
-    static const Range sAllRange = Range{ sMinBound, sMaxBound };
-
-    inline static size_t prefixSize(ComparatorPrefix p)
-    {
-        switch (p)
-        {
-        case ComparatorPrefix::NONE:
-            return 0;
-        case ComparatorPrefix::GTE:
-        case ComparatorPrefix::LTE:
-            return 2;
-        default:
-            return 1;
-
-        }
-    }
-
-    static SemverQueryParseResult queryParseResultFromVersionParseResult(SemverParseResult versionParseResult)
-    {
-
-        switch (versionParseResult)
-        {
-        case SEMVER_PARSE_SUCCESS:
-        case SEMVER_PARSE_MAJOR_WILDCARD:
-        case SEMVER_PARSE_MINOR_WILDCARD:
-        case SEMVER_PARSE_PATCH_WILDCARD:
-        case SEMVER_PARSE_TOO_FEW_PARTS:
-        
-        //whitespace leadin/ trailing non-fatal but we should never see this
-        case SEMVER_PARSE_LEADING_WHITESPACE:
-        case SEMVER_PARSE_TRAILING_WHITESPACE:
-
-        // builds are ignored so we should never see this
-        case SEMVER_PARSE_BUILD_EMPTY_IDENTIFIER:
-        case SEMVER_PARSE_BUILD_UNSUPPORTED_CHARACTER:
-        
- 
-            return SEMVER_QUERY_PARSE_SUCCESS;
-
-        default:
-            return static_cast<SemverQueryParseResult>(versionParseResult);
-        }
-
-
-    }
-
-
     const Bound& RangeSet::lowBound() const
     {
         
@@ -64,12 +17,12 @@ namespace semver
             return sMaxBound;
 
        
-        const Bound* min = &at(0).lower;
+        const Bound* min = &(*this)[0].lower;
 
         for (size_t i = 1; i < size(); ++i)
         {
-            if (Version::compare(at(i).lower.juncture, min->juncture) < 0)
-                min = &at(i).lower;
+            if (Version::compare((*this)[i].lower.juncture, min->juncture) < 0)
+                min = &(*this)[i].lower;
         }
 
         return *min;
@@ -80,176 +33,17 @@ namespace semver
         if (size() == 0)
             return sMinBound;
 
-        const Bound* max = &at(0).upper;
+        const Bound* max = &(*this)[0].upper;
 
         for (size_t i = 1; i < size(); ++i)
         {
-            if (Version::compare(at(i).upper.juncture, max->juncture) > 0)
-                max = &at(i).upper;
+            if (Version::compare((*this)[i].upper.juncture, max->juncture) > 0)
+                max = &(*this)[i].upper;
         }
 
         return *max;
     }
 
-    SemverQueryParseResult RangeSet::parse(const char* str, size_t len)
-	{ 
-        clear();
-
-        Range range = sAllRange;
- 
-        size_t tokenStart = 0;
-        size_t tokenEnd = 0;
-        SemverQueryParseResult parsedResult = SEMVER_QUERY_PARSE_SUCCESS;
-
-        for (size_t pos = 0; pos < len; )
-        {
-
-            while (pos < len && str[pos] <= ' ')
-                ++pos;
-
-            bool atEnd = pos == len;
-            bool atDivider;
-
-            if (atEnd)
-                atDivider = false;
-            else if (atDivider = str[pos] == '|' && str[pos + 1] == '|')
-            {
-                pos += 2;
-
-                while (pos < len && str[pos] <= ' ')
-                    ++pos;
-
-                atEnd = pos == len;
-            }
-
-            if (atEnd || atDivider)
-            {
-                push_back(range);
-
-                range = sAllRange;
-
-                if (atEnd) // consider combining overlapped ranges provided that explicit pre-release are retained
-                    break;
-            }
-
-            ComparatorPrefix prefix = ComparatorPrefix::NONE;
-            switch (str[pos])
-            {
-            case '=':
-                prefix = ComparatorPrefix::EQ;
-                break;
-
-            case '~':
-                prefix = ComparatorPrefix::TIL;
-                break;
-
-            case '^':
-                prefix = ComparatorPrefix::CAR;
-                break;
-
-            case '>':
-                if ((pos + 1 < len) && str[pos + 1] == '=')
-                    prefix = ComparatorPrefix::GTE;
-                else
-                    prefix = ComparatorPrefix::GT;
-                break;
-
-            case '<':
-                if ((pos + 1 < len) && str[pos + 1] == '=')
-                    prefix = ComparatorPrefix::LTE;
-                else
-                    prefix = ComparatorPrefix::LT;
-            }
-
-            pos += prefixSize(prefix);
-
-            if (prefix == ComparatorPrefix::NONE)
-                prefix = ComparatorPrefix::EQ; // set after adjusting pos
-
-            while (pos < len && str[pos] <= ' ')
-                ++pos;
-
-            size_t versionStart = pos;
-            ++pos;
-
-            atDivider = false;
-
-            while (pos < len && str[pos] >  ' ' && !(atDivider = str[pos] == '|'))
-                ++pos;
-
-
-            std::string_view versionStr(str + versionStart, pos - versionStart);
-
-            while (pos < len && str[pos] <= ' ')
-                ++pos;
-
-            SemverParseResult versionParseResult;
-            if (str[pos] == '-')
-            {
-                ++pos;
-                while (pos < len && str[pos] <= ' ')
-                    ++pos;
-
-                versionStart = pos;
-                ++pos;
-                while (pos < len && str[pos] >  ' ')
-                    ++pos;
-
-
-                std::string_view versionStr2(str + versionStart, pos - versionStart);
-
-                versionParseResult = range.addRange(versionStr, versionStr2);
-            }
-            else
-                versionParseResult = range.add(prefix, versionStr);
-
-             parsedResult =  queryParseResultFromVersionParseResult(versionParseResult);
-
-            if (!parsedResult == SEMVER_QUERY_PARSE_SUCCESS)
-                return parsedResult;
-
-            while (pos < len && str[pos] <= ' ')
-                ++pos;
-
-            if (str[pos] == '@')
-            {
-                ++pos;
-                size_t minPrereleaseStart = pos;
-                ++pos;
-
-                while (pos < len && str[pos] > ' ' && str[pos] != '|')
-                    pos++;
-
-                const char* prerelease = str + minPrereleaseStart;
-                size_t prereleaseLen = pos - minPrereleaseStart;
-
-                switch (Version::parsePrerelease(prerelease, prereleaseLen))
-                {
-                case Version::PreleaseParseResult::SUCCESS:
-                    break;
-
-                case Version::PreleaseParseResult::DIGITS_WITH_LEADING_ZERO:
-                    return SEMVER_QUERY_PARSE_MIN_PRERELEASE_LEADING_ZERO_ON_NUMERIC_IDENTIFIER;
-
-                case Version::PreleaseParseResult::EMPTY_IDENTIFIER:
-                    return SEMVER_QUERY_PARSE_MIN_PRERELEASE_EMPTY_IDENTIFIER;
-
-                case Version::PreleaseParseResult::UNSUPPORTED_CHARACTER:
-                    return SEMVER_QUERY_PARSE_MIN_PRERELEASE_UNSUPPORTED_CHARACTER;
-                }
-
-                range.minPreRelease = std::string(prerelease, prereleaseLen);
-
-            }
-
-        }
-
-        if (size() == 0 || !range.isAll()) // consider combining overlapped ranges provided that explicit pre-release are retained
-            push_back(range); //only or with all if not already have other bounds
-
-        return parsedResult;
-	}
-
     bool RangeSet::hasWithinAnyRangeBounds(const Version& version) const
     {
         for (const Range& r : *this)
@@ -259,461 +53,157 @@ namespace semver
         return false;
     }
 
-    bool RangeSet::matches(const Version& version) const
-    {
-        if (version.isDefined())
-        {
-            if (version.isPrerelease())
-            {
-                for (const Range& r : *this)
-                    if (r.matches(version))
-                        return true;
-            }
-            else
-                return hasWithinAnyRangeBounds(version);
-        }
-
-        return false;
-    }
-
-
     std::string Query::toString() const
     {
-        std::string result;
+        FormatBuffer measure{ nullptr, 0 };
+        format(measure);
 
-        if (rangeSet.size() == 0)
-        {
-           return "<0.0.0-0";
-        }
-        else
-        {
-            std::for_each(rangeSet.cbegin(), rangeSet.cend() - 1,
-                [&result](const Range& bounds)
-                {
-                    result += bounds.toString() + " || ";
-                }
-            );
-
-            result += rangeSet.back().toString();
-        }
+        std::string result(measure.len, '\0');
+        FormatBuffer out{ result.data(), result.size() + 1 }; // std::string always has room for the \0
+        format(out);
 
         return result;
     }
 
-
-    SemverParseResult Range::add(ComparatorPrefix prefix, std::string_view version_str)
+    void Query::format(FormatBuffer& out) const
     {
-        switch (prefix)
+        if (rangeSet.size() == 0)
         {
-
-        case ComparatorPrefix::TIL:
-            return addTildeComparator(version_str);
-
-        case ComparatorPrefix::CAR:
-            return addCaretComparator(version_str);
-
-
-        case ComparatorPrefix::GT:
-            return addMinimumAllowWildcards(version_str, Bound::Included::NO);
- 
-        case ComparatorPrefix::LT:
-            return addMaximumAllowWildcards(version_str, Bound::Included::NO);
-
-        case ComparatorPrefix::GTE:
-            return addMinimumAllowWildcards(version_str, Bound::Included::YES);
-
-        case ComparatorPrefix::LTE:
-            return addMaximumAllowWildcards(version_str, Bound::Included::YES);
-
+            out.put("<0.0.0-0");
+            return;
         }
 
-        return addExactOrWildcardComparator(version_str);
-
-    }
-
-    static bool rangeVersionParseResultOK(SemverParseResult parseResult)
-    {
-        switch (parseResult)
+        for (size_t i = 0; i < rangeSet.size(); ++i)
         {
-        case SEMVER_PARSE_SUCCESS:
-        case SEMVER_PARSE_MAJOR_WILDCARD:
-        case SEMVER_PARSE_MINOR_WILDCARD:
-        case SEMVER_PARSE_PATCH_WILDCARD:
-        case SEMVER_PARSE_TOO_FEW_PARTS:
-            // builds are just metadata and play no role in ranges
-        case SEMVER_PARSE_BUILD_EMPTY_IDENTIFIER:
-        case SEMVER_PARSE_BUILD_UNSUPPORTED_CHARACTER:
-
-            //    case SEMVER_QUERY_PARSE_PRERELEASE_SUB_RANGE_IDENTIFIER:
-            return true;
+            if (i > 0)
+                out.put(" || ");
 
+            rangeSet[i].format(out);
         }
-
-        return false;
     }
 
-    void Range::setToNone()
-    {
-        lower.juncture.clear();
-        upper.juncture.clear();
-        lower.juncture.flags = upper.juncture.flags = Version::Flags::MANAGED; // clear also cleared the managed flag
-        upper.included = lower.included = Bound::Included::NO;
-
-    }
 
-    void Range::setToAll()
+    Range Range::clone() const
     {
-        lower.juncture.major = lower.juncture.minor = lower.juncture.patch = 0;
-        lower.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
-
-        upper.juncture.major = upper.juncture.minor = upper.juncture.patch = SEMVER_MAX_NUMERIC_IDENTIFIER;
-        upper.juncture.deletePrerelease();
-
-        upper.included = lower.included = Bound::Included::YES;
-    }
+        Range copy = *this;
 
-
-    SemverParseResult Range::addTildeComparator(std::string_view version_str)
-    {
-        
-        SemverParseResult result = addMinimumAllowWildcards(version_str, Bound::Included::YES);
-
-        if (result == SEMVER_PARSE_MAJOR_WILDCARD)
+        for (Version* juncture : { &copy.lower.juncture, &copy.upper.juncture })
         {
-            setToAll();
-            return result;
-        }
+            juncture->flags &= ~Version::BUILD_IN_MAP; // builds are keyed on the original's address
 
-        if (result == SEMVER_PARSE_MINOR_WILDCARD /*|| result == SEMVER_PARSE_MINOR_EMPTY*/)
-        {
-            upper.juncture.major = lower.juncture.major + 1;
-            upper.juncture.minor = 0;
+            if (juncture->isPrereleaseOnHeap())
+            {
+                const char* prerelease = juncture->get_heap_prerelease();
+                juncture->flags &= ~Version::PRERELEASE_ON_HEAP; // so setPrerelease does not free the original's
+                juncture->setPrerelease(prerelease);
+            }
         }
-        else
+
+        if (copy.minPreRelease.onHeap)
         {
-            upper.juncture.major = lower.juncture.major;
-            upper.juncture.minor = lower.juncture.minor + 1;
+            const char* prerelease = minPreRelease.get_heap_prerelease();
+            copy.minPreRelease.onHeap = false; // so assign does not free the original's
+            copy.minPreRelease.assign(prerelease);
         }
 
-        upper.juncture.patch = 0;
-        upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
-        upper.matchPreReleases = Bound::MatchPreReleases::NO;
-        upper.included = Bound::Included::NO;
-
-        return result;
-
+        return copy;
     }
 
-    SemverParseResult Range::addCaretComparator(std::string_view version_str)
+    bool Range::lowerAdmits(const Version& version) const
     {
-
-        SemverParseResult result = addMinimumAllowWildcards(version_str, Bound::Included::YES);
-
-        if (result == SEMVER_PARSE_MAJOR_WILDCARD)
-        {
-            setToAll();
-            return result;
-        }
-     
-        if (result == SEMVER_PARSE_MINOR_WILDCARD || lower.juncture.major > 0)
-        {
-            upper.juncture.major = lower.juncture.major + 1;
-            upper.juncture.minor = upper.juncture.patch = 0;
-        }
-        else if (result == SEMVER_PARSE_PATCH_WILDCARD || lower.juncture.minor > 0)
-        {
-            upper.juncture.major = lower.juncture.major;
-            upper.juncture.minor = lower.juncture.minor + 1;
-            upper.juncture.patch = 0;
-        }
-        else
-        {
-            upper.juncture.major = lower.juncture.major;
-            upper.juncture.minor = lower.juncture.minor;
-            upper.juncture.patch = lower.juncture.patch + 1;
-        }
-
-        upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
-        upper.matchPreReleases = Bound::MatchPreReleases::NO;
-        upper.included = Bound::Included::NO;
-
-        return result;
-
+        int compareLower = Version::compare(version, lower.juncture);
+        return compareLower > 0 || (compareLower == 0 && lower.isIncluded());
     }
 
-    SemverParseResult Range::addMinimumAllowWildcards(std::string_view version_str, Bound::Included included)
+    bool Range::upperAdmits(const Version& version) const
     {
+        int compareUpper = Version::compare(version, upper.juncture);
+        return compareUpper < 0 || (compareUpper == 0 && upper.isIncluded());
+    }
 
-        SemverParseResult result = lower.juncture.parseIgnoreBuild(version_str.data(), version_str.size(), Version::UninitializedDefault::WILD);
-        
-
-        if (!rangeVersionParseResultOK(result))
-        {
-            setToNone();
-            return result;
-        }
-
-        
-        if (lower.juncture.majorIsWild())
-        {
-            if (included == Bound::Included::YES)
-                setToAll(); // >= * implies all
-            else
-                setToNone(); // > * implies nothing
-
-            return result;
-        }
-
-        bool minorWild = false;
-        bool patchWild = false;
-
-        if ((minorWild = lower.juncture.minorIsWild() || lower.juncture.minorIsUndefined()) || 
-            (patchWild = lower.juncture.patchIsWild() || lower.juncture.patchIsUndefined()))
-        {
-
-            if (minorWild)
-            {
-                result = SEMVER_PARSE_MINOR_WILDCARD;
-                lower.juncture.minor = 0;
-                if (included == Bound::Included::NO)  // > 2.x  :=  >= 3.0.0-0
-                     ++lower.juncture.major;
-                   
-            }
-            else // patch is wild
-            {
-                result = SEMVER_PARSE_PATCH_WILDCARD;
-                if (included == Bound::Included::NO)  // > 2.3.x  :=  >= 2.4.0-0
-                    ++lower.juncture.minor;
-            }
-
-            lower.juncture.patch = 0;
-
-            if (included == Bound::Included::NO)
-                upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
-            else
-                lower.juncture.deletePrerelease(); // >= 2.3.x  := >=2.3.0
+    bool Range::hasWithinBounds(const Version& version) const
+    {
+        return version.isDefined() && lowerAdmits(version) && upperAdmits(version);
+    }
 
-            lower.matchPreReleases = Bound::MatchPreReleases::NO;
-            lower.included = Bound::Included::YES; // see examples above
+    std::string Range::toString() const
+    {
+        FormatBuffer measure{ nullptr, 0 };
+        format(measure);
 
-        }
-        else
-        {
-           lower.included = included;
-           lower.matchPreReleases = lower.juncture.isPrerelease() ? Bound::MatchPreReleases::YES : Bound::MatchPreReleases::NO;
-        }
+        std::string result(measure.len, '\0');
+        FormatBuffer out{ result.data(), result.size() + 1 };
+        format(out);
 
         return result;
-
     }
 
-    SemverParseResult Range::addMaximumAllowWildcards(std::string_view version_str, Bound::Included included)
+    void Range::format(FormatBuffer& out) const
     {
-
-        SemverParseResult result = upper.juncture.parseIgnoreBuild(version_str.data(), version_str.size());
-
-
-        if (!rangeVersionParseResultOK(result))
-        {
-            setToNone();
-            return result;
-        }
-
-
-        if (upper.juncture.majorIsWild())
+        if (!isNone()) 
         {
-            if (included == Bound::Included::YES)
-                setToAll(); // <= * implies all
-            else
-               setToNone(); // < * implies nothing
-
-            return SEMVER_PARSE_MAJOR_WILDCARD;
+            out.put("<0.0.0-0"); // no version matches this
+            return;
         }
 
-        bool minorWild = false;
-        bool patchWild = false; 
-
-        if ((minorWild = upper.juncture.minorIsWild() || upper.juncture.minorIsUndefined()) ||
-            (patchWild = upper.juncture.patchIsWild() || upper.juncture.patchIsUndefined()))
-        {
-
-            if (minorWild) // < 2.x or <= 2.x
-            {
-                result = SEMVER_PARSE_MINOR_WILDCARD;
-
-                if (included == Bound::Included::YES) // <= 2.x := <3.0.0-0 
-                    ++upper.juncture.major;
-
-                upper.juncture.minor = 0;
-
-            }
-            else // patch is wild
-            {
-                result = SEMVER_PARSE_PATCH_WILDCARD;
-
-                if (included == Bound::Included::YES) // <= 2.3.x := < 2.4.0-0
-                    ++upper.juncture.minor;
-            }
-            
-            upper.juncture.patch = 0;
+        formatBounds(out);
 
-            if (included == Bound::Included::YES)
-                upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
-            else
-                upper.juncture.deletePrerelease(); // < 2.3.x := < 2.3.0
-
-
-            upper.included = Bound::Included::NO;
-            upper.matchPreReleases = Bound::MatchPreReleases::NO;
-        }
-        else
+        if (!minPreRelease.empty())
         {
-            upper.included = included;
-            upper.matchPreReleases = upper.juncture.isPrerelease() ? Bound::MatchPreReleases::YES : Bound::MatchPreReleases::NO;
+            out.put(" @"); // the parser ends versions at whitespace
+            out.put(minPreRelease.c_str());
         }
-
-        return result;
-
-
     }
 
-
-
-    SemverParseResult Range::addExactOrWildcardComparator(std::string_view version_str)
+    void Range::formatBounds(FormatBuffer& out) const
     {
-        SemverParseResult result = addMinimumAllowWildcards(version_str, Bound::Included::YES);
+        bool openBelow = lower.juncture.isMinimum() && !lower.canMatchPreReleases(); // >=0.0.0-0 also admits 0.0.0 prereleases
 
-        if (result == SEMVER_PARSE_MAJOR_WILDCARD)
-            return result; //already set to all;
-
-        if (!rangeVersionParseResultOK(result))
+        if (isAll() && openBelow)
         {
-            setToNone();
-            return result; //range already set to all if major is wildcard
+            out.put('x');
+            return;
         }
 
-
-        if (result == SEMVER_PARSE_MINOR_WILDCARD || result == SEMVER_PARSE_PATCH_WILDCARD)
-        {
-
-            if (result == SEMVER_PARSE_MINOR_WILDCARD) // = 2.x
-            {
-                result = SEMVER_PARSE_MINOR_WILDCARD;
-                upper.juncture.major = lower.juncture.major + 1; // 2.x := >= 2.0.0 <3.0.0-0
-                upper.juncture.minor = 0;
-
-            }
-            else // patch is wild
-            {
-                result = SEMVER_PARSE_PATCH_WILDCARD;
-                upper.juncture.major = lower.juncture.major;
-                upper.juncture.minor = lower.juncture.minor +1;  //2.3.x := >= 2.3.0 < 2.4.0-0
-            }
-
-            upper.juncture.patch = 0;
-            upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
-            upper.included = Bound::Included::NO;
-            upper.matchPreReleases = Bound::MatchPreReleases::NO;
-        }
-        else
+        if (upper.juncture.isMaximum())
         {
-            upper.juncture.major = lower.juncture.major;
-            upper.juncture.minor = lower.juncture.minor;
-            upper.juncture.patch = lower.juncture.patch;
-            upper.juncture.setPrerelease(lower.juncture.getPrerelease());
-            upper.included = lower.included;
-            upper.matchPreReleases = upper.matchPreReleases;
+            out.put(lower.isIncluded() ? ">=" : ">");
+            lower.juncture.format(out);
+            return;
         }
 
-        return result;
-    }
-
-    SemverParseResult Range::addRange(std::string_view version_from, std::string_view version_to)
-    {
-        SemverParseResult result = addMinimumAllowWildcards(version_from, Bound::Included::YES);
-
-        if (!rangeVersionParseResultOK(result)) // better to separate on fatal non fatal parse errors than isNone
-            return result;
-
-        return addMaximumAllowWildcards(version_to, Bound::Included::YES);
-    }
-
-   
-    bool Range::matches(const Version& version) const
-    {
-        if (hasWithinBounds(version))
+        if (openBelow)
         {
-            if (!version.isPrerelease())
-                return true;
-            else
-            {
-                return // prereleases need to meet extra conditions
-                    lower.canMatchPreReleases() && lower.juncture.sameCore(version) && lower.juncture.isPrerelease() ||
-                    upper.canMatchPreReleases() && upper.juncture.sameCore(version) && upper.juncture.isPrerelease() ||
-                    !minPreRelease.empty() && Version::comparePrereleases(minPreRelease.c_str(), version.getPrerelease()) <= 0;
-            }
+            out.put(upper.isIncluded() ? "<=" : "<");
+            upper.juncture.format(out);
+            return;
         }
 
-        return false;
-
-    }
-
-    bool Range::hasWithinBounds(const Version& version) const
-    {
-        if (!version.isDefined())
-            return false;
-
-        int compareLower = Version::compare(version, lower.juncture);
-        if (compareLower < 0) 
-            return false;
-
-        int compareUpper = Version::compare(version, upper.juncture);
-        if (compareUpper > 0) 
-            return false;
-
-        return (compareLower > 0 && compareUpper < 0) ||
-            (compareLower == 0 && lower.isIncluded()) ||
-            (compareUpper == 0 && upper.isIncluded());
- 
-
-    }
-
-    std::string Range::toString() const
-    {
-        if (!isNone()) 
-            return "<0.0.0-0"; // no version matches this
-
-        std::string minPreReleaseTag; 
-
-        if (!minPreRelease.empty())
-            minPreReleaseTag = '@' + minPreRelease;
-        else
-            minPreReleaseTag = "";
-
-        if (isAll())
-           return "x" + minPreReleaseTag;
-
-        if (upper.juncture.isMaximum())
-            return (lower.isIncluded() ? ">=" : ">") + std::string(lower.juncture.toString());
-
-        if (lower.juncture.isMinimum())
-            return (upper.isIncluded() ? "<=" : "<") + std::string(upper.juncture.toString());
-
-
         if (lower.isIncluded())
         {
             if (upper.isIncluded())
             {
+                lower.juncture.format(out);
+
                 if (upper == lower)
-                    return lower.juncture.toString();
+                    return;
 
-                return lower.juncture.toString() + " - " + upper.juncture.toString();
+                out.put(" - ");
+                upper.juncture.format(out);
+                return;
             }
 
-            return ">=" + lower.juncture.toString() + " <" + upper.juncture.toString();
+            out.put(">=");
+            lower.juncture.format(out);
+            out.put(" <");
+            upper.juncture.format(out);
+            return;
         }
 
-        return '>' + lower.juncture.toString() + (upper.isIncluded() ? " <=" : " <") + upper.juncture.toString() + minPreReleaseTag;
+        out.put('>');
+        lower.juncture.format(out);
+        out.put(upper.isIncluded() ? " <=" : " <");
+        upper.juncture.format(out);
     }
 
 
@@ -2,7 +2,7 @@
 
 #pragma once
 #include "version.h"
-#include <vector>
+#include "small_vector.h"
 #include <string>
 #include "semver.h"
 
@@ -29,8 +29,8 @@ namespace semver
 
 		MatchPreReleases matchPreReleases;
 
-		inline bool canMatchPreReleases() const { return matchPreReleases == MatchPreReleases::YES; }
-		inline bool isIncluded() const { return included == Included::YES; }
+		constexpr bool canMatchPreReleases() const { return matchPreReleases == MatchPreReleases::YES; }
+		constexpr bool isIncluded() const { return included == Included::YES; }
 
 
 		inline bool operator==(const Bound& other) const
@@ -41,9 +41,9 @@ namespace semver
 		void setToMin();
 		void setToMax();
 
-		Bound() { juncture.flags = Version::MANAGED;	}
+		constexpr Bound() { juncture.flags = Version::MANAGED;	}
 
-		Bound(const Version& juncture, Included included, MatchPreReleases matchPreReleases)
+		constexpr Bound(const Version& juncture, Included included, MatchPreReleases matchPreReleases)
 			: juncture{ juncture }, included{ included }, matchPreReleases{ matchPreReleases }
 		{
 			this->juncture.flags |= Version::MANAGED;
@@ -51,6 +51,54 @@ namespace semver
 
 	};
 
+	// the minimum prerelease of a range, stored like the prerelease of a Version: inline when it is shorter than
+	// Version::inline_prerelease_len, on the heap otherwise. Copies share the heap string, Range::clone copies it
+	struct MinPreRelease
+	{
+		char inline_prerelease[Version::inline_prerelease_len] = {};
+		bool onHeap = false;
+
+		constexpr const char* c_str() const { return onHeap ? get_heap_prerelease() : inline_prerelease; }
+		constexpr size_t size() const { return strlenSafe(c_str()); }
+		constexpr bool empty() const { return !onHeap && inline_prerelease[0] == '\0'; }
+
+		constexpr void assign(const char* str, size_t len)
+		{
+			clear();
+			if (len < Version::inline_prerelease_len)
+				std::copy_n(str, len, inline_prerelease);
+			else
+			{
+				stats::count(stats::PRERELEASE_HEAP_SPILLS);
+				setHeapPrerelease(cloneStr(str, len)); // not a constant expression: static queries keep it inline
+			}
+		}
+
+		constexpr void assign(const char* str) { assign(str, strlenSafe(str)); }
+
+		constexpr void clear() // frees a heap string
+		{
+			if (onHeap)
+				delete[] get_heap_prerelease();
+
+			onHeap = false;
+			std::fill_n(inline_prerelease, Version::inline_prerelease_len, '\0');
+		}
+
+		const char* get_heap_prerelease() const
+		{
+			const char* ptr;
+			memcpy(&ptr, inline_prerelease, sizeof(ptr)); // the first sizeof(pointer) chars hold the pointer
+			return ptr;
+		}
+
+		void setHeapPrerelease(const char* ptr)
+		{
+			memcpy(inline_prerelease, &ptr, sizeof(ptr));
+			onHeap = true;
+		}
+	};
+
 	enum class ComparatorPrefix : uint8_t
 	{
 		NONE, // defaults to EQ, but does not move parser cursor
@@ -67,7 +115,7 @@ namespace semver
 	{
 		Bound lower;
 		Bound upper;
-		std::string minPreRelease;
+		MinPreRelease minPreRelease;
 
 		inline bool isNone() const
 		{
@@ -79,37 +127,108 @@ namespace semver
 		}
 
 	
-		bool isAll() const
+		constexpr bool isAll() const
 		{
 			return upper.juncture.isMaximum() && lower.juncture.isMinimum();
 		}
 
-		SemverParseResult add(ComparatorPrefix prefix, std::string_view version_str);
+		constexpr SemverParseResult add(ComparatorPrefix prefix, std::string_view version_str);
+
+		constexpr void setToNone();
+
+		constexpr void setToAll();
 
-		void setToNone();
 
-		void setToAll();
+		constexpr SemverParseResult addTildeComparator(std::string_view version_str);
 
+		constexpr SemverParseResult addCaretComparator(std::string_view version_str);
 
-		SemverParseResult addTildeComparator(std::string_view version_str);
+		constexpr SemverParseResult addMinimumAllowWildcards(std::string_view version_str, Bound::Included included);
 
-		SemverParseResult addCaretComparator(std::string_view version_str);
+		constexpr SemverParseResult addMaximumAllowWildcards(std::string_view version_str, Bound::Included included);
 
-		SemverParseResult addMinimumAllowWildcards(std::string_view version_str, Bound::Included included);
+		constexpr SemverParseResult addExactOrWildcardComparator(std::string_view version_str);
 
-		SemverParseResult addMaximumAllowWildcards(std::string_view version_str, Bound::Included included);
+		constexpr SemverParseResult addRange(std::string_view version_from, std::string_view version_to);
 
-		SemverParseResult addExactOrWildcardComparator(std::string_view version_str);
+		// the comparators step past the largest numeric identifier for the next version (^9007199254740991 would end
+		// at 9007199254740992.0.0-0), such bounds are clamped: an upper bound to the maximum, a lower one matches nothing
+		constexpr void clampToMaximum()
+		{
+			auto pastMaximum = [](const Version& v)
+				{
+					return v.major > SEMVER_MAX_NUMERIC_IDENTIFIER || v.minor > SEMVER_MAX_NUMERIC_IDENTIFIER || v.patch > SEMVER_MAX_NUMERIC_IDENTIFIER;
+				};
+
+			if (pastMaximum(lower.juncture))
+				setToNone();
+			else if (pastMaximum(upper.juncture))
+			{
+				upper.juncture.major = upper.juncture.minor = upper.juncture.patch = SEMVER_MAX_NUMERIC_IDENTIFIER;
+				upper.juncture.deletePrerelease();
+				upper.included = Bound::Included::YES;
+				upper.matchPreReleases = Bound::MatchPreReleases::NO;
+			}
+		}
 
-		SemverParseResult addRange(std::string_view version_from, std::string_view version_to);
 
+		Range clone() const; // copies share heap prereleases, clones have their own
 
+		constexpr void deleteHeapResources()
+		{
+			lower.juncture.deleteHeapResources();
+			upper.juncture.deleteHeapResources();
+			minPreRelease.clear();
+		}
+
+		bool lowerAdmits(const Version& version) const; // true for all versions from the lower bound up
+		bool upperAdmits(const Version& version) const; // true for all versions up to the upper bound
 		bool hasWithinBounds(const Version& version) const;
-		bool matches(const Version& version) const;
+
+		// stable versions fall within the bounds by their core alone, the prereleases of a core precede its stable version
+		constexpr bool hasStableWithinBounds(const Version& stable) const
+		{
+			int compareLower = Version::compareCores(stable, lower.juncture);
+
+			if (compareLower < 0 || (compareLower == 0 && !lower.isIncluded() && !lower.juncture.isPrerelease()))
+				return false;
+
+			int compareUpper = Version::compareCores(stable, upper.juncture);
+			return compareUpper < 0 || (compareUpper == 0 && upper.isIncluded() && !upper.juncture.isPrerelease());
+		}
+
+		constexpr bool canMatchPreReleases() const // whatever its junctures are edited to
+		{
+			return lower.canMatchPreReleases() || upper.canMatchPreReleases() || !minPreRelease.empty();
+		}
+
+		constexpr bool matches(const Version& version) const
+		{
+			if (!version.isDefined())
+				return false;
+
+			int compareLower = Version::compare(version, lower.juncture);
+
+			if (compareLower < 0 || (compareLower == 0 && !lower.isIncluded()))
+				return false;
+
+			int compareUpper = Version::compare(version, upper.juncture);
+
+			if (compareUpper > 0 || (compareUpper == 0 && !upper.isIncluded()))
+				return false;
+
+			return !version.isPrerelease() || // prereleases need to meet extra conditions
+				lower.canMatchPreReleases() && lower.juncture.sameCore(version) && lower.juncture.isPrerelease() ||
+				upper.canMatchPreReleases() && upper.juncture.sameCore(version) && upper.juncture.isPrerelease() ||
+				!minPreRelease.empty() && Version::comparePrereleases(minPreRelease.c_str(), version.getPrerelease()) <= 0;
+		}
+
 		std::string toString() const;
+		void format(FormatBuffer& out) const;
+		void formatBounds(FormatBuffer& out) const; // without the minimum prerelease
 
 
-		Range()
+		constexpr Range()
 			: lower{ Version{0, 0, 0, Version::MANAGED, '0' }, 
 				Bound::Included::YES, Bound::MatchPreReleases::NO },
 
@@ -117,21 +236,61 @@ namespace semver
 				Bound::Included::YES, Bound::MatchPreReleases::NO }
 		{}
 
-		Range(const Bound& lower, const Bound& upper) 
+		constexpr Range(const Bound& lower, const Bound& upper) 
 			: lower{ lower }, upper{ upper } 
 		{}
 
 
 	};
 
-	struct RangeSet : std::vector<Range> 
+	struct RangeSet : SmallVector<Range, 2> // most queries have one or two ranges, those parse without allocating
 	{
+		bool stableOnly = false; // no range can match prereleases, chosen when the set is built (see chooseMatcher)
+
 		const Bound& lowBound() const;
 		const Bound& highBound() const;
 
 		bool hasWithinAnyRangeBounds(const Version& version) const;
-		bool matches(const Version& version) const;
-		SemverQueryParseResult parse(const char* str, size_t len); // SVQL 1.0.0 queries were only a range set
+		constexpr SemverQueryParseResult parse(const char* str, size_t len); // SVQL 1.0.0 queries were only a range set
+
+		// picks the matcher for the ranges as they are now. Call again after adding ranges that can match prereleases
+		constexpr void chooseMatcher()
+		{
+			stableOnly = std::none_of(begin(), end(), [](const Range& r) { return r.canMatchPreReleases(); });
+		}
+
+		template <bool StableOnly>
+		constexpr bool matchesWith(const Version& version) const
+		{
+			if (!version.isDefined())
+				return false;
+
+			if (version.isPrerelease())
+			{
+				if constexpr (StableOnly)
+					return false;
+				else
+				{
+					for (const Range& r : *this)
+						if (r.matches(version))
+							return true;
+
+					return false;
+				}
+			}
+
+			for (const Range& r : *this)
+				if (r.hasStableWithinBounds(version))
+					return true;
+
+			return false;
+		}
+
+		bool matches(const Version& version) const
+		{
+			stats::count(stats::QUERY_MATCHES);
+			return stableOnly ? matchesWith<true>(version) : matchesWith<false>(version);
+		}
 
 	};
 
@@ -150,7 +309,7 @@ namespace semver
 			return rangeSet.highBound(); 
 		}
 
-		SemverQueryParseResult parse(const char* str, size_t len)
+		constexpr SemverQueryParseResult parse(const char* str, size_t len)
 		{
 			return rangeSet.parse(str, len); // SVQL 1.0.0 queries were only a range set
 		}
@@ -166,10 +325,572 @@ namespace semver
 		}
 
 		std::string toString() const;
+		void format(FormatBuffer& out) const;
 	
 	};
 
 
+	// parsing, constexpr so queries can be built at compile time (see literals.h)
+	///////////////////////////////////////////////////////////////////////////////
+
+	constexpr size_t prefixSize(ComparatorPrefix p)
+	{
+		switch (p)
+		{
+		case ComparatorPrefix::NONE:
+			return 0;
+		case ComparatorPrefix::GTE:
+		case ComparatorPrefix::LTE:
+			return 2;
+		default:
+			return 1;
+
+		}
+	}
+
+	constexpr SemverQueryParseResult queryParseResultFromVersionParseResult(SemverParseResult versionParseResult)
+	{
+
+		switch (versionParseResult)
+		{
+		case SEMVER_PARSE_SUCCESS:
+		case SEMVER_PARSE_MAJOR_WILDCARD:
+		case SEMVER_PARSE_MINOR_WILDCARD:
+		case SEMVER_PARSE_PATCH_WILDCARD:
+		case SEMVER_PARSE_TOO_FEW_PARTS:
+		
+		//whitespace leadin/ trailing non-fatal but we should never see this
+		case SEMVER_PARSE_LEADING_WHITESPACE:
+		case SEMVER_PARSE_TRAILING_WHITESPACE:
+
+		// builds are ignored so we should never see this
+		case SEMVER_PARSE_BUILD_EMPTY_IDENTIFIER:
+		case SEMVER_PARSE_BUILD_UNSUPPORTED_CHARACTER:
+		
+ 
+			return SEMVER_QUERY_PARSE_SUCCESS;
+
+		default:
+			return static_cast<SemverQueryParseResult>(versionParseResult);
+		}
+
+
+	}
+
+	constexpr bool rangeVersionParseResultOK(SemverParseResult parseResult)
+	{
+		switch (parseResult)
+		{
+		case SEMVER_PARSE_SUCCESS:
+		case SEMVER_PARSE_MAJOR_WILDCARD:
+		case SEMVER_PARSE_MINOR_WILDCARD:
+		case SEMVER_PARSE_PATCH_WILDCARD:
+		case SEMVER_PARSE_TOO_FEW_PARTS:
+			// builds are just metadata and play no role in ranges
+		case SEMVER_PARSE_BUILD_EMPTY_IDENTIFIER:
+		case SEMVER_PARSE_BUILD_UNSUPPORTED_CHARACTER:
+
+			//    case SEMVER_QUERY_PARSE_PRERELEASE_SUB_RANGE_IDENTIFIER:
+			return true;
+
+		}
+
+		return false;
+	}
+
+	constexpr SemverQueryParseResult RangeSet::parse(const char* str, size_t len)
+	{ 
+		// re-parsing reuses the capacity of the set, so a query parsed again and again does not allocate. Only
+		// prereleases that did not fit inline and builds added through handles are freed
+		for (Range& r : *this)
+			r.deleteHeapResources();
+
+		clear();
+		stableOnly = false; // until the ranges are complete
+
+		Range range; // all versions until bounds are added
+		bool pending = true; // an alternative is open, it is added even if empty (all versions, as in node-semver)
+
+		auto fail = [&range](SemverQueryParseResult result) // the ranges already added are kept
+		{
+			range.deleteHeapResources();
+			return result;
+		};
+ 
+		size_t tokenStart = 0;
+		size_t tokenEnd = 0;
+		SemverQueryParseResult parsedResult = SEMVER_QUERY_PARSE_SUCCESS;
+
+		for (size_t pos = 0; pos < len; )
+		{
+
+			while (pos < len && str[pos] <= ' ')
+				++pos;
+
+			bool atEnd = pos == len;
+			bool atDivider;
+
+			if (atEnd)
+				atDivider = false;
+			else if (atDivider = str[pos] == '|' && pos + 1 < len && str[pos + 1] == '|')
+			{
+				pos += 2;
+
+				while (pos < len && str[pos] <= ' ')
+					++pos;
+
+				atEnd = pos == len;
+			}
+
+			if (atEnd || atDivider)
+			{
+				push_back(range);
+
+				range = Range();
+				pending = atDivider; // also when the text ends after it
+
+				if (atEnd) // consider combining overlapped ranges provided that explicit pre-release are retained
+					break;
+			}
+
+			ComparatorPrefix prefix = ComparatorPrefix::NONE;
+			switch (str[pos])
+			{
+			case '=':
+				prefix = ComparatorPrefix::EQ;
+				break;
+
+			case '~':
+				prefix = ComparatorPrefix::TIL;
+				break;
+
+			case '^':
+				prefix = ComparatorPrefix::CAR;
+				break;
+
+			case '>':
+				if ((pos + 1 < len) && str[pos + 1] == '=')
+					prefix = ComparatorPrefix::GTE;
+				else
+					prefix = ComparatorPrefix::GT;
+				break;
+
+			case '<':
+				if ((pos + 1 < len) && str[pos + 1] == '=')
+					prefix = ComparatorPrefix::LTE;
+				else
+					prefix = ComparatorPrefix::LT;
+			}
+
+			pos += prefixSize(prefix);
+
+			if (prefix == ComparatorPrefix::NONE)
+				prefix = ComparatorPrefix::EQ; // set after adjusting pos
+
+			while (pos < len && str[pos] <= ' ')
+				++pos;
+
+			size_t versionStart = pos;
+			if (pos < len)
+				++pos;
+
+			atDivider = false;
+
+			while (pos < len && str[pos] >  ' ' && !(atDivider = str[pos] == '|'))
+				++pos;
+
+
+			std::string_view versionStr(str + versionStart, pos - versionStart);
+
+			while (pos < len && str[pos] <= ' ')
+				++pos;
+
+			SemverParseResult versionParseResult;
+			if (pos < len && str[pos] == '-')
+			{
+				++pos;
+				while (pos < len && str[pos] <= ' ')
+					++pos;
+
+				versionStart = pos;
+				if (pos < len)
+					++pos;
+				while (pos < len && str[pos] >  ' ')
+					++pos;
+
+
+				std::string_view versionStr2(str + versionStart, pos - versionStart);
+
+				versionParseResult = range.addRange(versionStr, versionStr2);
+			}
+			else
+				versionParseResult = range.add(prefix, versionStr);
+
+			range.clampToMaximum();
+
+			 parsedResult =  queryParseResultFromVersionParseResult(versionParseResult);
+
+			if (!parsedResult == SEMVER_QUERY_PARSE_SUCCESS)
+				return fail(parsedResult);
+
+			while (pos < len && str[pos] <= ' ')
+				++pos;
+
+			if (pos < len && str[pos] == '@')
+			{
+				++pos;
+				size_t minPrereleaseStart = pos;
+				if (pos < len)
+					++pos;
+
+				while (pos < len && str[pos] > ' ' && str[pos] != '|')
+					pos++;
+
+				const char* prerelease = str + minPrereleaseStart;
+				size_t prereleaseLen = pos - minPrereleaseStart;
+
+				switch (Version::parsePrerelease(prerelease, prereleaseLen))
+				{
+				case Version::PreleaseParseResult::SUCCESS:
+					break;
+
+				case Version::PreleaseParseResult::DIGITS_WITH_LEADING_ZERO:
+					return fail(SEMVER_QUERY_PARSE_MIN_PRERELEASE_LEADING_ZERO_ON_NUMERIC_IDENTIFIER);
+
+				case Version::PreleaseParseResult::EMPTY_IDENTIFIER:
+					return fail(SEMVER_QUERY_PARSE_MIN_PRERELEASE_EMPTY_IDENTIFIER);
+
+				case Version::PreleaseParseResult::UNSUPPORTED_CHARACTER:
+					return fail(SEMVER_QUERY_PARSE_MIN_PRERELEASE_UNSUPPORTED_CHARACTER);
+				}
+
+				range.minPreRelease.assign(prerelease, prereleaseLen);
+
+			}
+
+		}
+
+		if (pending) // the text ended right after the last alternative, or is empty (which matches all)
+			push_back(range);
+
+		chooseMatcher();
+		return parsedResult;
+	}
+
+	constexpr SemverParseResult Range::add(ComparatorPrefix prefix, std::string_view version_str)
+	{
+		switch (prefix)
+		{
+
+		case ComparatorPrefix::TIL:
+			return addTildeComparator(version_str);
+
+		case ComparatorPrefix::CAR:
+			return addCaretComparator(version_str);
+
+
+		case ComparatorPrefix::GT:
+			return addMinimumAllowWildcards(version_str, Bound::Included::NO);
+ 
+		case ComparatorPrefix::LT:
+			return addMaximumAllowWildcards(version_str, Bound::Included::NO);
+
+		case ComparatorPrefix::GTE:
+			return addMinimumAllowWildcards(version_str, Bound::Included::YES);
+
+		case ComparatorPrefix::LTE:
+			return addMaximumAllowWildcards(version_str, Bound::Included::YES);
+
+		}
+
+		return addExactOrWildcardComparator(version_str);
+
+	}
+
+	constexpr void Range::setToNone()
+	{
+		lower.juncture.clear();
+		upper.juncture.clear();
+		lower.juncture.flags = upper.juncture.flags = Version::Flags::MANAGED; // clear also cleared the managed flag
+		upper.included = lower.included = Bound::Included::NO;
+
+	}
+
+	constexpr void Range::setToAll()
+	{
+		lower.juncture.major = lower.juncture.minor = lower.juncture.patch = 0;
+		lower.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
+
+		upper.juncture.major = upper.juncture.minor = upper.juncture.patch = SEMVER_MAX_NUMERIC_IDENTIFIER;
+		upper.juncture.deletePrerelease();
+
+		upper.included = lower.included = Bound::Included::YES;
+	}
+
+
+	constexpr SemverParseResult Range::addTildeComparator(std::string_view version_str)
+	{
+		
+		SemverParseResult result = addMinimumAllowWildcards(version_str, Bound::Included::YES);
+
+		if (result == SEMVER_PARSE_MAJOR_WILDCARD)
+		{
+			setToAll();
+			return result;
+		}
+
+		if (result == SEMVER_PARSE_MINOR_WILDCARD /*|| result == SEMVER_PARSE_MINOR_EMPTY*/)
+		{
+			upper.juncture.major = lower.juncture.major + 1;
+			upper.juncture.minor = 0;
+		}
+		else
+		{
+			upper.juncture.major = lower.juncture.major;
+			upper.juncture.minor = lower.juncture.minor + 1;
+		}
+
+		upper.juncture.patch = 0;
+		upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
+		upper.matchPreReleases = Bound::MatchPreReleases::NO;
+		upper.included = Bound::Included::NO;
+
+		return result;
+
+	}
+
+	constexpr SemverParseResult Range::addCaretComparator(std::string_view version_str)
+	{
+
+		SemverParseResult result = addMinimumAllowWildcards(version_str, Bound::Included::YES);
+
+		if (result == SEMVER_PARSE_MAJOR_WILDCARD)
+		{
+			setToAll();
+			return result;
+		}
+	 
+		if (result == SEMVER_PARSE_MINOR_WILDCARD || lower.juncture.major > 0)
+		{
+			upper.juncture.major = lower.juncture.major + 1;
+			upper.juncture.minor = upper.juncture.patch = 0;
+		}
+		else if (result == SEMVER_PARSE_PATCH_WILDCARD || lower.juncture.minor > 0)
+		{
+			upper.juncture.major = lower.juncture.major;
+			upper.juncture.minor = lower.juncture.minor + 1;
+			upper.juncture.patch = 0;
+		}
+		else
+		{
+			upper.juncture.major = lower.juncture.major;
+			upper.juncture.minor = lower.juncture.minor;
+			upper.juncture.patch = lower.juncture.patch + 1;
+		}
+
+		upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
+		upper.matchPreReleases = Bound::MatchPreReleases::NO;
+		upper.included = Bound::Included::NO;
+
+		return result;
+
+	}
+
+	constexpr SemverParseResult Range::addMinimumAllowWildcards(std::string_view version_str, Bound::Included included)
+	{
+
+		SemverParseResult result = lower.juncture.parseIgnoreBuild(version_str.data(), version_str.size(), Version::UninitializedDefault::WILD);
+		
+
+		if (!rangeVersionParseResultOK(result))
+		{
+			setToNone();
+			return result;
+		}
+
+		
+		if (lower.juncture.majorIsWild())
+		{
+			if (included == Bound::Included::YES)
+				setToAll(); // >= * implies all
+			else
+				setToNone(); // > * implies nothing
+
+			return result;
+		}
+
+		bool minorWild = false;
+		bool patchWild = false;
+
+		if ((minorWild = lower.juncture.minorIsWild() || lower.juncture.minorIsUndefined()) || 
+			(patchWild = lower.juncture.patchIsWild() || lower.juncture.patchIsUndefined()))
+		{
+
+			if (minorWild)
+			{
+				result = SEMVER_PARSE_MINOR_WILDCARD;
+				lower.juncture.minor = 0;
+				if (included == Bound::Included::NO)  // > 2.x  :=  >= 3.0.0-0
+					 ++lower.juncture.major;
+				   
+			}
+			else // patch is wild
+			{
+				result = SEMVER_PARSE_PATCH_WILDCARD;
+				if (included == Bound::Included::NO)  // > 2.3.x  :=  >= 2.4.0-0
+					++lower.juncture.minor;
+			}
+
+			lower.juncture.patch = 0;
+
+			if (included == Bound::Included::NO)
+				upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
+			else
+				lower.juncture.deletePrerelease(); // >= 2.3.x  := >=2.3.0
+
+			lower.matchPreReleases = Bound::MatchPreReleases::NO;
+			lower.included = Bound::Included::YES; // see examples above
+
+		}
+		else
+		{
+		   lower.included = included;
+		   lower.matchPreReleases = lower.juncture.isPrerelease() ? Bound::MatchPreReleases::YES : Bound::MatchPreReleases::NO;
+		}
+
+		return result;
+
+	}
+
+	constexpr SemverParseResult Range::addMaximumAllowWildcards(std::string_view version_str, Bound::Included included)
+	{
+
+		SemverParseResult result = upper.juncture.parseIgnoreBuild(version_str.data(), version_str.size());
+
+
+		if (!rangeVersionParseResultOK(result))
+		{
+			setToNone();
+			return result;
+		}
+
+
+		if (upper.juncture.majorIsWild())
+		{
+			if (included == Bound::Included::YES)
+				setToAll(); // <= * implies all
+			else
+			   setToNone(); // < * implies nothing
+
+			return SEMVER_PARSE_MAJOR_WILDCARD;
+		}
+
+		bool minorWild = false;
+		bool patchWild = false; 
+
+		if ((minorWild = upper.juncture.minorIsWild() || upper.juncture.minorIsUndefined()) ||
+			(patchWild = upper.juncture.patchIsWild() || upper.juncture.patchIsUndefined()))
+		{
+
+			if (minorWild) // < 2.x or <= 2.x
+			{
+				result = SEMVER_PARSE_MINOR_WILDCARD;
+
+				if (included == Bound::Included::YES) // <= 2.x := <3.0.0-0 
+					++upper.juncture.major;
+
+				upper.juncture.minor = 0;
+
+			}
+			else // patch is wild
+			{
+				result = SEMVER_PARSE_PATCH_WILDCARD;
+
+				if (included == Bound::Included::YES) // <= 2.3.x := < 2.4.0-0
+					++upper.juncture.minor;
+			}
+			
+			upper.juncture.patch = 0;
+
+			if (included == Bound::Included::YES)
+				upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
+			else
+				upper.juncture.deletePrerelease(); // < 2.3.x := < 2.3.0
+
+
+			upper.included = Bound::Included::NO;
+			upper.matchPreReleases = Bound::MatchPreReleases::NO;
+		}
+		else
+		{
+			upper.included = included;
+			upper.matchPreReleases = upper.juncture.isPrerelease() ? Bound::MatchPreReleases::YES : Bound::MatchPreReleases::NO;
+		}
+
+		return result;
+
+
+	}
+
+
+
+	constexpr SemverParseResult Range::addExactOrWildcardComparator(std::string_view version_str)
+	{
+		SemverParseResult result = addMinimumAllowWildcards(version_str, Bound::Included::YES);
+
+		if (result == SEMVER_PARSE_MAJOR_WILDCARD)
+			return result; //already set to all;
+
+		if (!rangeVersionParseResultOK(result))
+		{
+			setToNone();
+			return result; //range already set to all if major is wildcard
+		}
+
+
+		if (result == SEMVER_PARSE_MINOR_WILDCARD || result == SEMVER_PARSE_PATCH_WILDCARD)
+		{
+
+			if (result == SEMVER_PARSE_MINOR_WILDCARD) // = 2.x
+			{
+				result = SEMVER_PARSE_MINOR_WILDCARD;
+				upper.juncture.major = lower.juncture.major + 1; // 2.x := >= 2.0.0 <3.0.0-0
+				upper.juncture.minor = 0;
+
+			}
+			else // patch is wild
+			{
+				result = SEMVER_PARSE_PATCH_WILDCARD;
+				upper.juncture.major = lower.juncture.major;
+				upper.juncture.minor = lower.juncture.minor +1;  //2.3.x := >= 2.3.0 < 2.4.0-0
+			}
+
+			upper.juncture.patch = 0;
+			upper.juncture.setPrerelease(SEMVER_LOWEST_PRERELEASE, 1);
+			upper.included = Bound::Included::NO;
+			upper.matchPreReleases = Bound::MatchPreReleases::NO;
+		}
+		else
+		{
+			upper.juncture.major = lower.juncture.major;
+			upper.juncture.minor = lower.juncture.minor;
+			upper.juncture.patch = lower.juncture.patch;
+			upper.juncture.setPrerelease(lower.juncture.getPrerelease());
+			upper.included = lower.included;
+			upper.matchPreReleases = upper.matchPreReleases;
+		}
+
+		return result;
+	}
+
+	constexpr SemverParseResult Range::addRange(std::string_view version_from, std::string_view version_to)
+	{
+		SemverParseResult result = addMinimumAllowWildcards(version_from, Bound::Included::YES);
+
+		if (!rangeVersionParseResultOK(result)) // better to separate on fatal non fatal parse errors than isNone
+			return result;
 
+		return addMaximumAllowWildcards(version_to, Bound::Included::YES);
+	}
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,450 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "range_algebra.h"
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace semver
+{
+	namespace
+	{
+		// a cut in the version order, just before or just after a version
+		struct Point
+		{
+			uint64_t major = 0, minor = 0, patch = 0;
+			std::string prerelease; // empty for stable versions
+			bool after = false;
+
+			bool isPrerelease() const { return !prerelease.empty(); }
+			bool isMinimum() const { return major == 0 && minor == 0 && patch == 0 && prerelease == SEMVER_LOWEST_PRERELEASE && !after; }
+
+			Point core() const { return { major, minor, patch, {}, false }; } // before the stable version, after all its prereleases
+			Point nextCore() const { return { major, minor, patch + 1, {}, false }; }
+			Point withPrerelease(std::string tag) const { return { major, minor, patch, std::move(tag), false }; }
+		};
+
+		// versions of an interval: stable versions always, prereleases from minPreRelease up (none if empty)
+		struct Segment
+		{
+			Point lo;
+			Point hi;
+			std::string minPreRelease;
+		};
+
+		typedef std::vector<Segment> Segments; // ascending and disjoint, with versions between them unless minPreRelease differs
+
+		int compareVersions(const Point& lhs, const Point& rhs) // ignores the side of the cut
+		{
+			if (lhs.major != rhs.major)
+				return (lhs.major < rhs.major) ? -1 : 1;
+
+			if (lhs.minor != rhs.minor)
+				return (lhs.minor < rhs.minor) ? -1 : 1;
+
+			if (lhs.patch != rhs.patch)
+				return (lhs.patch < rhs.patch) ? -1 : 1;
+
+			if (!lhs.isPrerelease() || !rhs.isPrerelease()) // stable versions follow their prereleases
+				return static_cast<int>(!lhs.isPrerelease()) - static_cast<int>(!rhs.isPrerelease());
+
+			if (lhs.prerelease == rhs.prerelease) // bounds often share their prerelease, a memcmp instead of identifier by identifier
+				return 0;
+
+			return Version::comparePrereleases(lhs.prerelease.c_str(), rhs.prerelease.c_str());
+		}
+
+		int compare(const Point& lhs, const Point& rhs)
+		{
+			int comp = compareVersions(lhs, rhs);
+			return comp != 0 ? comp : static_cast<int>(lhs.after) - static_cast<int>(rhs.after);
+		}
+
+		bool below(const Point& version, const Point& cut)
+		{
+			int comp = compareVersions(version, cut);
+			return comp < 0 || (comp == 0 && cut.after);
+		}
+
+		int compareMinimums(const std::string& lhs, const std::string& rhs) // higher admits fewer prereleases, empty (none) is highest
+		{
+			if (lhs.empty() || rhs.empty() || lhs == rhs)
+				return static_cast<int>(lhs.empty()) - static_cast<int>(rhs.empty());
+
+			return Version::comparePrereleases(lhs.c_str(), rhs.c_str());
+		}
+
+		Point pointAt(const Version& juncture, bool after)
+		{
+			return { juncture.major, juncture.minor, juncture.patch, juncture.getPrerelease(), after };
+		}
+
+		Version versionAt(const Point& point)
+		{
+			Version v{ point.major, point.minor, point.patch, Version::MANAGED };
+
+			if (point.isPrerelease())
+				v.setPrerelease(point.prerelease.data(), point.prerelease.size());
+
+			return v;
+		}
+
+		Point lowestStable(const Point& lo) // lowest stable version above the cut
+		{
+			return (lo.isPrerelease() || !lo.after) ? lo.core() : lo.nextCore();
+		}
+
+		Point lowestPrerelease(const Point& lo, const std::string& minPreRelease) // lowest prerelease above the cut, from minPreRelease up
+		{
+			if (!lo.isPrerelease()) // the prereleases of a stable version precede it
+				return lo.nextCore().withPrerelease(minPreRelease);
+
+			if (Version::comparePrereleases(minPreRelease.c_str(), lo.prerelease.c_str()) > 0)
+				return lo.withPrerelease(minPreRelease);
+
+			return lo.withPrerelease(lo.after ? lo.prerelease + ".0" : lo.prerelease); // x.0 directly follows x
+		}
+
+		bool hasStable(const Segment& s)
+		{
+			return below(lowestStable(s.lo), s.hi);
+		}
+
+		bool hasPrereleases(const Segment& s, const std::string& from, const std::string& to) // with from <= prerelease < to (empty: no limit)
+		{
+			if (from.empty())
+				return false;
+
+			Point first = lowestPrerelease(s.lo, from);
+
+			if (!below(first, s.hi))
+				return false;
+
+			if (to.empty() || Version::comparePrereleases(first.prerelease.c_str(), to.c_str()) < 0)
+				return true;
+
+			return below(first.nextCore().withPrerelease(from), s.hi); // the next core starts over from the lowest prereleases
+		}
+
+		bool hasVersions(const Segment& s)
+		{
+			return hasStable(s) || hasPrereleases(s, s.minPreRelease, {});
+		}
+
+		// merges with the last segment when they have the same minimum and no version between them would be left out
+		void append(Segments& segments, const Point& lo, const Point& hi, const std::string& minPreRelease)
+		{
+			if (!segments.empty() && segments.back().minPreRelease == minPreRelease && !hasVersions({ segments.back().hi, lo, minPreRelease }))
+				segments.back().hi = hi;
+			else
+				segments.push_back({ lo, hi, minPreRelease });
+		}
+
+		// visits the intervals between consecutive bounds of both, where at least one covers the interval. Stops when visit returns false
+		template <typename Visit>
+		void sweep(const Segments& lhs, const Segments& rhs, Visit visit)
+		{
+			auto bound = [](const Segments& s, size_t i) -> const Point& { return (i % 2 == 0) ? s[i / 2].lo : s[i / 2].hi; };
+
+			size_t l = 0; // bounds passed, odd while inside a segment
+			size_t r = 0;
+			const Point* previous = nullptr;
+
+			while (l < lhs.size() * 2 || r < rhs.size() * 2)
+			{
+				const Point* next;
+
+				if (l == lhs.size() * 2)
+					next = &bound(rhs, r);
+				else if (r == rhs.size() * 2 || compare(bound(lhs, l), bound(rhs, r)) <= 0)
+					next = &bound(lhs, l);
+				else
+					next = &bound(rhs, r);
+
+				if (previous && (l % 2 || r % 2) && compare(*previous, *next) < 0)
+					if (!visit(*previous, *next, (l % 2) ? &lhs[l / 2] : nullptr, (r % 2) ? &rhs[r / 2] : nullptr))
+						return;
+
+				while (l < lhs.size() * 2 && compare(bound(lhs, l), *next) == 0) // touching segments are passed together
+					++l;
+
+				while (r < rhs.size() * 2 && compare(bound(rhs, r), *next) == 0)
+					++r;
+
+				previous = next;
+			}
+		}
+
+		Segments uniteSegments(const Segments& lhs, const Segments& rhs)
+		{
+			Segments united;
+
+			sweep(lhs, rhs, [&](const Point& lo, const Point& hi, const Segment* l, const Segment* r)
+				{
+					const Segment* lower = !r || (l && compareMinimums(l->minPreRelease, r->minPreRelease) <= 0) ? l : r;
+					append(united, lo, hi, lower->minPreRelease);
+					return true;
+				});
+
+			return united;
+		}
+
+		Segments intersectSegments(const Segments& lhs, const Segments& rhs)
+		{
+			Segments intersection;
+
+			sweep(lhs, rhs, [&](const Point& lo, const Point& hi, const Segment* l, const Segment* r)
+				{
+					if (l && r)
+						append(intersection, lo, hi, compareMinimums(l->minPreRelease, r->minPreRelease) >= 0 ? l->minPreRelease : r->minPreRelease);
+
+					return true;
+				});
+
+			return intersection;
+		}
+
+		// united in one sweep over the bounds of all segments, each interval between two bounds gets the lowest minimum of
+		// the segments covering it
+		Segments uniteAll(const Segments& segments)
+		{
+			struct Cut
+			{
+				const Point* at;
+				const std::string* minPreRelease;
+				bool starts;
+			};
+
+			std::vector<Cut> cuts;
+			cuts.reserve(segments.size() * 2);
+
+			for (const Segment& s : segments)
+			{
+				cuts.push_back({ &s.lo, &s.minPreRelease, true });
+				cuts.push_back({ &s.hi, &s.minPreRelease, false });
+			}
+
+			std::sort(cuts.begin(), cuts.end(), [](const Cut& x, const Cut& y) { return compare(*x.at, *y.at) < 0; });
+
+			auto lower = [](const std::string* x, const std::string* y) { return compareMinimums(*x, *y) < 0; };
+			std::multiset<const std::string*, decltype(lower)> covering(lower);
+			Segments united;
+
+			for (size_t i = 0; i < cuts.size(); )
+			{
+				const Point& at = *cuts[i].at;
+
+				for (; i < cuts.size() && compare(*cuts[i].at, at) == 0; ++i)
+				{
+					if (cuts[i].starts)
+						covering.insert(cuts[i].minPreRelease);
+					else
+						covering.erase(covering.find(cuts[i].minPreRelease)); // any with the same minimum
+				}
+
+				if (!covering.empty() && i < cuts.size())
+					append(united, at, *cuts[i].at, **covering.begin());
+			}
+
+			return united;
+		}
+
+		Segments normalize(const RangeSet& ranges)
+		{
+			Segments parts;
+
+			for (const Range& r : ranges)
+			{
+				Point lo = pointAt(r.lower.juncture, !r.lower.isIncluded());
+				Point hi = pointAt(r.upper.juncture, r.upper.isIncluded());
+
+				if (compare(lo, hi) >= 0)
+					continue; // matches nothing
+
+				parts.push_back({ lo, hi, r.minPreRelease.c_str() });
+
+				// prerelease bounds also admit the prereleases of their own core within the range
+				if (r.lower.canMatchPreReleases() && r.lower.juncture.isPrerelease())
+					parts.push_back({ lo, (compare(lo.core(), hi) < 0) ? lo.core() : hi, SEMVER_LOWEST_PRERELEASE });
+
+				if (r.upper.canMatchPreReleases() && r.upper.juncture.isPrerelease())
+				{
+					Point start = hi.withPrerelease(SEMVER_LOWEST_PRERELEASE);
+					start = (compare(start, lo) > 0) ? start : lo;
+
+					if (compare(start, hi) < 0)
+						parts.push_back({ start, hi, SEMVER_LOWEST_PRERELEASE });
+				}
+			}
+
+			return uniteAll(parts);
+		}
+
+		struct Piece : Segment
+		{
+			bool prereleasesOnly; // all of one core, the lower bound admits them
+		};
+
+		void appendPrereleases(std::vector<Piece>& pieces, const Segment& s)
+		{
+			if (s.minPreRelease.empty())
+				return;
+
+			Point first = lowestPrerelease(s.lo, s.minPreRelease);
+
+			if (below(first, s.hi))
+				pieces.push_back({ { first, s.hi, {} }, true });
+		}
+
+		// lowerAdmitsCore: the range starts with prereleases of the core of lo, which the lower bound has to opt in to. Other
+		// ranges start at a stable version or at the minimum, from where only minPreRelease admits prereleases
+		Range rangeOf(const Point& lo, const Point& hi, const std::string& minPreRelease, bool lowerAdmitsCore)
+		{
+			Bound lower{ versionAt(lo), lo.after ? Bound::Included::NO : Bound::Included::YES,
+				lowerAdmitsCore ? Bound::MatchPreReleases::YES : Bound::MatchPreReleases::NO };
+
+			Bound upper{ versionAt(hi), hi.after ? Bound::Included::YES : Bound::Included::NO,
+				hi.isPrerelease() ? Bound::MatchPreReleases::YES : Bound::MatchPreReleases::NO };
+
+			Range range{ lower, upper };
+			range.minPreRelease.assign(minPreRelease.c_str(), minPreRelease.size());
+			return range;
+		}
+
+		// ranges that parse back to the same versions: prerelease bounds admit their own core, so intervals that
+		// admit only some prereleases of a core at their ends are split off there
+		RangeSet toRangeSet(const Segments& segments)
+		{
+			std::vector<Piece> pieces;
+
+			for (const Segment& s : segments)
+			{
+				if (!hasStable(s))
+				{
+					appendPrereleases(pieces, s);
+					continue;
+				}
+
+				Piece body{ s, false };
+
+				if (s.minPreRelease.empty()) // only stable versions, so the bounds need no prereleases
+				{
+					if (body.lo.isPrerelease() && !body.lo.isMinimum())
+						body.lo = s.lo.core();
+
+					if (body.hi.isPrerelease())
+						body.hi = s.hi.core();
+
+					pieces.push_back(body);
+					continue;
+				}
+
+				if (s.lo.isPrerelease() && !s.lo.isMinimum())
+				{
+					appendPrereleases(pieces, { s.lo, s.lo.core(), s.minPreRelease });
+					body.lo = s.lo.core();
+				}
+
+				bool splitHi = s.hi.isPrerelease() && (s.hi.prerelease != SEMVER_LOWEST_PRERELEASE || s.hi.after);
+
+				if (splitHi)
+					body.hi = s.hi.withPrerelease(SEMVER_LOWEST_PRERELEASE);
+
+				pieces.push_back(body);
+
+				if (splitHi)
+					appendPrereleases(pieces, { body.hi, s.hi, s.minPreRelease });
+			}
+
+			RangeSet ranges;
+
+			for (size_t i = 0; i < pieces.size(); ++i)
+			{
+				const Piece* head = pieces[i].prereleasesOnly ? &pieces[i] : nullptr;
+				const Piece* body = head ? nullptr : &pieces[i];
+
+				if (head && i + 1 < pieces.size() && !pieces[i + 1].prereleasesOnly && compare(head->hi, pieces[i + 1].lo) == 0)
+					body = &pieces[++i]; // the prereleases lead up to the stable version the body starts at
+
+				const Piece* tail = nullptr;
+
+				if (body && i + 1 < pieces.size() && pieces[i + 1].prereleasesOnly)
+				{
+					const Point& start = pieces[i + 1].lo;
+					bool fromLowest = start.prerelease == SEMVER_LOWEST_PRERELEASE && !start.after;
+					bool bodyEnds = !body->hi.after && (!body->hi.isPrerelease() || body->hi.prerelease == SEMVER_LOWEST_PRERELEASE);
+
+					// the prereleases of the core the body ends at, up to a prerelease bound that admits them
+					if (fromLowest && bodyEnds && pieces[i + 1].hi.isPrerelease() && compareVersions(start.core(), body->hi.core()) == 0)
+						tail = &pieces[++i];
+				}
+
+				ranges.push_back(rangeOf(head ? head->lo : body->lo, tail ? tail->hi : body ? body->hi : head->hi, body ? body->minPreRelease : std::string(), head != nullptr));
+			}
+
+			return ranges;
+		}
+
+		Segments universe()
+		{
+			Range all;
+			return { { pointAt(all.lower.juncture, false), pointAt(all.upper.juncture, true), {} } };
+		}
+	}
+
+	RangeSet intersect(const RangeSet& lhs, const RangeSet& rhs)
+	{
+		return toRangeSet(intersectSegments(normalize(lhs), normalize(rhs)));
+	}
+
+	RangeSet unite(const RangeSet& lhs, const RangeSet& rhs)
+	{
+		return toRangeSet(uniteSegments(normalize(lhs), normalize(rhs)));
+	}
+
+	RangeSet complement(const RangeSet& ranges)
+	{
+		Segments gaps;
+
+		sweep(universe(), normalize(ranges), [&](const Point& lo, const Point& hi, const Segment*, const Segment* covered)
+			{
+				if (!covered)
+					append(gaps, lo, hi, {});
+
+				return true;
+			});
+
+		return toRangeSet(gaps);
+	}
+
+	bool isSubsetOf(const RangeSet& lhs, const RangeSet& rhs)
+	{
+		bool subset = true;
+
+		sweep(normalize(lhs), normalize(rhs), [&](const Point& lo, const Point& hi, const Segment* l, const Segment* r)
+			{
+				if (!l)
+					return true;
+
+				if (!r)
+					subset = !hasVersions({ lo, hi, l->minPreRelease });
+				else if (compareMinimums(r->minPreRelease, l->minPreRelease) > 0) // rhs admits fewer of the prereleases
+					subset = !hasPrereleases({ lo, hi, {} }, l->minPreRelease, r->minPreRelease);
+
+				return subset;
+			});
+
+		return subset;
+	}
+
+	bool isDisjoint(const RangeSet& lhs, const RangeSet& rhs)
+	{
+		bool disjoint = true;
+
+		for (const Segment& s : intersectSegments(normalize(lhs), normalize(rhs)))
+			disjoint = disjoint && !hasVersions(s);
+
+		return disjoint;
+	}
+
+}
@@ -0,0 +1,20 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include "range.h"
+
+namespace semver
+{
+	// Set operations on the versions range sets match, computed on their bounds instead of on versions. Range sets are
+	// first normalized into ascending, disjoint intervals that each admit prereleases from a minimum prerelease up, so the
+	// explicit prerelease bounds and minPreRelease of a range become intervals too. Normalizing sorts the bounds of all
+	// ranges once (n log n), operations on normalized sets are linear.
+	// Results are built from new ranges, which own their prereleases (free them with Range::deleteHeapResources)
+
+	RangeSet intersect(const RangeSet& lhs, const RangeSet& rhs); // versions both match
+	RangeSet unite(const RangeSet& lhs, const RangeSet& rhs); // versions either matches
+	RangeSet complement(const RangeSet& ranges); // stable versions ranges does not match, prereleases are not opted in to
+	bool isSubsetOf(const RangeSet& lhs, const RangeSet& rhs); // every version lhs matches, rhs matches too
+	bool isDisjoint(const RangeSet& lhs, const RangeSet& rhs); // no version matches both
+
+}
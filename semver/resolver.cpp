@@ -0,0 +1,771 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "resolver.h"
+#include <algorithm>
+#include <bit>
+
+namespace semver
+{
+
+	// version sets
+	///////////////
+
+	VersionSet VersionSet::empty(uint32_t count)
+	{
+		VersionSet set;
+		set.count = count;
+		set.bits.assign((count + 63) / 64, 0);
+		return set;
+	}
+
+	VersionSet VersionSet::all(uint32_t count)
+	{
+		VersionSet set = empty(count);
+		return set.complement();
+	}
+
+	VersionSet VersionSet::single(uint32_t count, uint32_t rank)
+	{
+		VersionSet set = empty(count);
+		set.insert(rank);
+		return set;
+	}
+
+	size_t VersionSet::size() const
+	{
+		size_t size = 0;
+
+		for (uint64_t word : bits)
+			size += std::popcount(word);
+
+		return size;
+	}
+
+	bool VersionSet::isEmpty() const
+	{
+		return !none && std::all_of(bits.begin(), bits.end(), [](uint64_t word) { return word == 0; });
+	}
+
+	bool VersionSet::isAll() const
+	{
+		return none && size() == count;
+	}
+
+	int64_t VersionSet::highest() const
+	{
+		for (size_t i = bits.size(); i-- > 0; )
+			if (bits[i])
+				return i * 64 + 63 - std::countl_zero(bits[i]);
+
+		return -1;
+	}
+
+	VersionSet& VersionSet::intersect(const VersionSet& other)
+	{
+		for (size_t i = 0; i < bits.size(); ++i)
+			bits[i] &= other.bits[i];
+
+		none = none && other.none;
+		return *this;
+	}
+
+	VersionSet& VersionSet::unite(const VersionSet& other)
+	{
+		for (size_t i = 0; i < bits.size(); ++i)
+			bits[i] |= other.bits[i];
+
+		none = none || other.none;
+		return *this;
+	}
+
+	VersionSet VersionSet::complement() const
+	{
+		VersionSet set = *this;
+
+		for (uint64_t& word : set.bits)
+			word = ~word;
+
+		if (count % 64) // no ranks past the last version
+			set.bits.back() &= (1ull << (count % 64)) - 1;
+
+		set.none = !none;
+		return set;
+	}
+
+	bool VersionSet::isSubsetOf(const VersionSet& other) const
+	{
+		if (none && !other.none)
+			return false;
+
+		for (size_t i = 0; i < bits.size(); ++i)
+			if (bits[i] & ~other.bits[i])
+				return false;
+
+		return true;
+	}
+
+	bool VersionSet::isDisjoint(const VersionSet& other) const
+	{
+		if (none && other.none)
+			return false;
+
+		for (size_t i = 0; i < bits.size(); ++i)
+			if (bits[i] & other.bits[i])
+				return false;
+
+		return true;
+	}
+
+
+	// packages
+	///////////
+
+	Resolver::Resolver()
+	{
+		Package& root = packages.emplace_back();
+		root.name = "root";
+		root.defined = true;
+		root.versionCount = 1;
+		root.dependencies.resize(1);
+	}
+
+	Resolver::~Resolver()
+	{
+		for (Package& p : packages)
+			for (auto& dependencies : p.dependencies)
+				for (Dependency& d : dependencies)
+					for (Range& r : d.ranges)
+						r.deleteHeapResources();
+	}
+
+	uint32_t Resolver::packageFor(std::string_view name)
+	{
+		auto [it, added] = packageIndex.try_emplace(std::string(name), static_cast<uint32_t>(packages.size()));
+
+		if (added)
+			packages.emplace_back().name = name;
+
+		return it->second;
+	}
+
+	bool Resolver::addPackage(std::string_view name, const Version* const* versions, size_t count)
+	{
+		Package& p = packages[packageFor(name)];
+
+		if (p.defined)
+			return false;
+
+		p.defined = true;
+		p.versionCount = static_cast<uint32_t>(count);
+		p.ranked.assign(versions, versions + count);
+
+		std::vector<uint32_t> byRank(count);
+
+		for (uint32_t i = 0; i < count; ++i)
+			byRank[i] = i;
+
+		std::stable_sort(byRank.begin(), byRank.end(), [versions](uint32_t a, uint32_t b) { return *versions[a] < *versions[b]; });
+
+		p.rankOfIndex.resize(count);
+
+		for (uint32_t rank = 0; rank < count; ++rank)
+		{
+			p.ranked[rank] = versions[byRank[rank]];
+			p.rankOfIndex[byRank[rank]] = rank;
+		}
+
+		p.dependencies.resize(count);
+		return true;
+	}
+
+	bool Resolver::addDependency(std::string_view name, size_t versionIndex, std::string_view dependency, const RangeSet& ranges)
+	{
+		auto it = packageIndex.find(std::string(name));
+
+		if (it == packageIndex.end() || !packages[it->second].defined || versionIndex >= packages[it->second].versionCount)
+			return false;
+
+		Dependency d{};
+		d.package = packageFor(dependency); // may add a package, so packages is indexed again below
+		d.text = std::string(dependency) + " " + Query{ "", ranges }.toString();
+
+		for (const Range& r : ranges)
+			d.ranges.push_back(r.clone());
+
+		d.ranges.chooseMatcher();
+
+		Package& p = packages[it->second];
+		p.dependencies[p.rankOfIndex[versionIndex]].push_back(std::move(d));
+		return true;
+	}
+
+	void Resolver::require(std::string_view name, const RangeSet& ranges)
+	{
+		Dependency d{};
+		d.package = packageFor(name);
+		d.text = std::string(name) + " " + Query{ "", ranges }.toString();
+
+		for (const Range& r : ranges)
+			d.ranges.push_back(r.clone());
+
+		d.ranges.chooseMatcher();
+
+		packages[sRoot].dependencies[0].push_back(std::move(d));
+	}
+
+	const VersionSet& Resolver::allowedBy(Dependency& dependency)
+	{
+		if (!dependency.computed)
+		{
+			const Package& p = packages[dependency.package];
+			dependency.allowed = VersionSet::empty(p.versionCount);
+
+			for (uint32_t rank = 0; rank < p.versionCount; ++rank)
+				if (dependency.ranges.matches(*p.ranked[rank]))
+					dependency.allowed.insert(rank);
+
+			dependency.computed = true;
+		}
+
+		return dependency.allowed;
+	}
+
+	const Version* Resolver::selectedVersion(std::string_view name) const
+	{
+		for (const Selection& s : selected)
+			if (*s.name == name)
+				return s.version;
+
+		return nullptr;
+	}
+
+
+	// solving
+	//////////
+
+	uint32_t Resolver::addIncompatibility(std::vector<Term> terms, Cause cause, uint32_t left, uint32_t right, uint32_t dependency)
+	{
+		std::vector<Term> merged; // one term per package: all terms of a package are satisfied when their intersection is
+
+		for (Term& t : terms)
+		{
+			auto same = std::find_if(merged.begin(), merged.end(), [&t](const Term& m) { return m.package == t.package; });
+
+			if (same == merged.end())
+				merged.push_back(std::move(t));
+			else
+				same->set.intersect(t.set);
+		}
+
+		std::erase_if(merged, [](const Term& t) { return t.set.isAll(); }); // always satisfied
+
+		incompatibilities.push_back({ std::move(merged), cause, left, right, dependency });
+		return static_cast<uint32_t>(incompatibilities.size() - 1);
+	}
+
+	void Resolver::registerIncompatibility(uint32_t incompatibility)
+	{
+		for (const Term& t : incompatibilities[incompatibility].terms)
+			packages[t.package].incompatibilities.push_back(incompatibility);
+	}
+
+	Resolver::Relation Resolver::relation(const Term& term) const
+	{
+		const Package& p = packages[term.package];
+
+		if (p.assignments.empty()) // anything is still possible
+			return term.set.isAll() ? Relation::SATISFIED : term.set.isEmpty() ? Relation::CONTRADICTED : Relation::INCONCLUSIVE;
+
+		if (p.current.isSubsetOf(term.set))
+			return Relation::SATISFIED;
+
+		if (p.current.isDisjoint(term.set))
+			return Relation::CONTRADICTED;
+
+		return Relation::INCONCLUSIVE;
+	}
+
+	void Resolver::assign(uint32_t package, VersionSet set, int64_t cause)
+	{
+		Package& p = packages[package];
+
+		if (p.assignments.empty())
+			p.current = set;
+		else
+			p.current.intersect(set);
+
+		p.assignments.push_back(static_cast<uint32_t>(assignments.size()));
+		assignments.push_back({ package, std::move(set), level, cause });
+	}
+
+	void Resolver::backtrack(uint32_t toLevel)
+	{
+		std::vector<uint32_t> touched;
+
+		while (!assignments.empty() && assignments.back().level > toLevel)
+		{
+			Package& p = packages[assignments.back().package];
+			p.assignments.pop_back();
+
+			if (assignments.back().cause < 0)
+				p.decided = -1;
+
+			touched.push_back(assignments.back().package);
+			assignments.pop_back();
+		}
+
+		for (uint32_t package : touched)
+		{
+			Package& p = packages[package];
+
+			for (size_t i = 0; i < p.assignments.size(); ++i)
+			{
+				if (i == 0)
+					p.current = assignments[p.assignments[i]].set;
+				else
+					p.current.intersect(assignments[p.assignments[i]].set);
+			}
+		}
+
+		level = toLevel;
+	}
+
+	int64_t Resolver::satisfier(const Term& term) const
+	{
+		const Package& p = packages[term.package];
+		VersionSet accumulated;
+
+		for (size_t i = 0; i < p.assignments.size(); ++i)
+		{
+			const Assignment& a = assignments[p.assignments[i]];
+
+			if (i == 0)
+				accumulated = a.set;
+			else
+				accumulated.intersect(a.set);
+
+			if (accumulated.isSubsetOf(term.set))
+				return p.assignments[i];
+		}
+
+		return -1; // PRE: term is satisfied, so this is not reached
+	}
+
+	int64_t Resolver::propagateIncompatibility(uint32_t incompatibility, bool& conflict)
+	{
+		const std::vector<Term>& terms = incompatibilities[incompatibility].terms;
+		const Term* unsatisfied = nullptr;
+		conflict = false;
+
+		for (const Term& t : terms)
+		{
+			switch (relation(t))
+			{
+			case Relation::CONTRADICTED:
+				return -1;
+
+			case Relation::INCONCLUSIVE:
+				if (unsatisfied)
+					return -1; // more than one term could still fail
+
+				unsatisfied = &t;
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		if (!unsatisfied)
+		{
+			conflict = true;
+			return -1;
+		}
+
+		uint32_t package = unsatisfied->package;
+		assign(package, unsatisfied->set.complement(), incompatibility); // the only way left to avoid the incompatibility
+		return package;
+	}
+
+	bool Resolver::propagate(uint32_t package)
+	{
+		std::vector<uint32_t> changed{ package };
+
+		while (!changed.empty())
+		{
+			uint32_t p = changed.back();
+			changed.pop_back();
+
+			for (size_t i = packages[p].incompatibilities.size(); i-- > 0; ) // most recent (derived) incompatibilities first
+			{
+				uint32_t incompatibility = packages[p].incompatibilities[i];
+				bool conflict;
+				int64_t derived = propagateIncompatibility(incompatibility, conflict);
+
+				if (conflict)
+				{
+					int64_t rootCause = resolveConflict(incompatibility);
+
+					if (rootCause < 0)
+						return false;
+
+					derived = propagateIncompatibility(static_cast<uint32_t>(rootCause), conflict); // almost satisfied after backtracking
+					changed.clear();
+
+					if (derived >= 0)
+						changed.push_back(static_cast<uint32_t>(derived));
+
+					break;
+				}
+
+				if (derived >= 0 && std::find(changed.begin(), changed.end(), derived) == changed.end())
+					changed.push_back(static_cast<uint32_t>(derived));
+			}
+		}
+
+		return true;
+	}
+
+	int64_t Resolver::resolveConflict(uint32_t incompatibility)
+	{
+		bool derivedNew = false;
+
+		if (++conflictCount % 256 == 0) // recent conflicts weigh more
+			for (Package& p : packages)
+				p.conflicts /= 2;
+
+		while (true)
+		{
+			const std::vector<Term>& terms = incompatibilities[incompatibility].terms;
+
+			for (const Term& t : terms)
+				++packages[t.package].conflicts;
+
+			if (terms.empty() || (terms.size() == 1 && terms[0].package == sRoot && !terms[0].set.none)) // the root can not be selected
+			{
+				failure = incompatibility;
+				return -1;
+			}
+
+			size_t mostRecentTerm = 0;
+			int64_t mostRecentSatisfier = -1;
+			VersionSet difference;
+			bool hasDifference = false;
+			uint32_t previousLevel = 1; // the root decision is never undone
+
+			for (size_t i = 0; i < terms.size(); ++i)
+			{
+				int64_t s = satisfier(terms[i]);
+
+				if (mostRecentSatisfier < 0 || s > mostRecentSatisfier)
+				{
+					if (mostRecentSatisfier >= 0)
+						previousLevel = std::max(previousLevel, assignments[mostRecentSatisfier].level);
+
+					mostRecentTerm = i;
+					mostRecentSatisfier = s;
+					hasDifference = false;
+				}
+				else
+					previousLevel = std::max(previousLevel, assignments[s].level);
+
+				if (mostRecentTerm == i) // the satisfier may satisfy the term only together with earlier assignments
+				{
+					difference = assignments[s].set;
+					difference.intersect(terms[i].set.complement());
+					hasDifference = !difference.isEmpty();
+
+					if (hasDifference)
+						previousLevel = std::max(previousLevel, assignments[satisfier({ terms[i].package, difference.complement() })].level);
+				}
+			}
+
+			const Assignment& satisfierAssignment = assignments[mostRecentSatisfier];
+
+			if (previousLevel < satisfierAssignment.level || satisfierAssignment.cause < 0)
+			{
+				backtrack(previousLevel);
+
+				if (derivedNew)
+					registerIncompatibility(incompatibility);
+
+				return incompatibility;
+			}
+
+			// the satisfier was derived, so replace it by the incompatibility it was derived from
+			uint32_t cause = static_cast<uint32_t>(satisfierAssignment.cause);
+			uint32_t satisfierPackage = satisfierAssignment.package;
+			std::vector<Term> merged;
+
+			for (size_t i = 0; i < terms.size(); ++i)
+				if (i != mostRecentTerm)
+					merged.push_back(terms[i]);
+
+			for (const Term& t : incompatibilities[cause].terms)
+				if (t.package != satisfierPackage)
+					merged.push_back(t);
+
+			if (hasDifference)
+				merged.push_back({ satisfierPackage, difference.complement() });
+
+			incompatibility = addIncompatibility(std::move(merged), Cause::DERIVED, incompatibility, cause);
+			derivedNew = true;
+		}
+	}
+
+	int64_t Resolver::decide()
+	{
+		int64_t best = -1;
+		uint32_t bestConflicts = 0;
+		size_t bestCount = 0;
+
+		for (uint32_t i = 0; i < packages.size(); ++i) // required, undecided package with the fewest versions left
+		{
+			const Package& p = packages[i];
+
+			if (p.decided >= 0 || p.assignments.empty() || p.current.none)
+				continue;
+
+			size_t count = p.current.size();
+
+			if (best < 0 || p.conflicts > bestConflicts || (p.conflicts == bestConflicts && count < bestCount))
+			{
+				best = i;
+				bestConflicts = p.conflicts;
+				bestCount = count;
+			}
+		}
+
+		if (best < 0)
+			return -1;
+
+		uint32_t package = static_cast<uint32_t>(best);
+		uint32_t rank = static_cast<uint32_t>(packages[package].current.highest()); // derivations never empty a required package
+		bool conflict = false;
+
+		for (uint32_t d = 0; d < packages[package].dependencies[rank].size(); ++d)
+		{
+			Dependency& dependency = packages[package].dependencies[rank][d];
+
+			if (dependency.added) // decided before and backtracked, or covered by another version
+				continue;
+
+			// every version with the same dependency shares the incompatibility, so what is learned from it covers them all
+			uint32_t count = packages[package].versionCount;
+			const VersionSet& allowed = allowedBy(dependency);
+			VersionSet depending = VersionSet::empty(count);
+
+			for (uint32_t other = 0; other < count; ++other)
+			{
+				for (Dependency& same : packages[package].dependencies[other])
+				{
+					if (!same.added && same.package == dependency.package && allowedBy(same) == allowed)
+					{
+						same.added = true;
+						depending.insert(other);
+					}
+				}
+			}
+
+			std::vector<Term> terms;
+			terms.push_back({ package, std::move(depending) });
+			terms.push_back({ dependency.package, allowed.complement() }); // not selected, or outside the allowed versions
+
+			uint32_t incompatibility = addIncompatibility(std::move(terms), Cause::DEPENDENCY, package, rank, d);
+			registerIncompatibility(incompatibility);
+
+			bool satisfiedByDeciding = true; // then propagation rules the version out instead
+
+			for (const Term& t : incompatibilities[incompatibility].terms)
+				satisfiedByDeciding = satisfiedByDeciding && (t.package == package ? t.set.contains(rank) : relation(t) == Relation::SATISFIED);
+
+			conflict = conflict || satisfiedByDeciding;
+		}
+
+		if (!conflict)
+		{
+			++level;
+			packages[package].decided = rank;
+			assign(package, VersionSet::single(packages[package].versionCount, rank), -1);
+		}
+
+		return package;
+	}
+
+	bool Resolver::solve()
+	{
+		for (Package& p : packages)
+		{
+			p.assignments.clear();
+			p.decided = -1;
+			p.conflicts = 0;
+			p.incompatibilities.clear();
+
+			for (auto& dependencies : p.dependencies)
+				for (Dependency& d : dependencies)
+				{
+					d.computed = false; // versions may have been added since
+					d.added = false;
+				}
+		}
+
+		incompatibilities.clear();
+		assignments.clear();
+		conflictCount = 0;
+		selected.clear();
+		level = 0;
+		failure = -1;
+
+		VersionSet rootSelected = VersionSet::single(1, 0);
+		registerIncompatibility(addIncompatibility({ { sRoot, rootSelected.complement() } }, Cause::ROOT, 0, 0));
+
+		for (int64_t next = sRoot; next >= 0; next = decide())
+			if (!propagate(static_cast<uint32_t>(next)))
+				return false;
+
+		for (const Assignment& a : assignments)
+			if (a.cause < 0 && a.package != sRoot)
+				selected.push_back({ &packages[a.package].name, packages[a.package].ranked[a.set.highest()] });
+
+		return true;
+	}
+
+
+	// explaining
+	/////////////
+
+	std::string Resolver::describe(const Term& term) const
+	{
+		const Package& p = packages[term.package];
+		VersionSet versions = term.set.none ? term.set.complement() : term.set; // negative terms are described by what they exclude
+		std::string text = term.set.none ? "not " + p.name : p.name;
+
+		if (term.package == sRoot)
+			return text;
+
+		if (versions.size() == p.versionCount && p.versionCount > 1)
+			return text + " (any version)";
+
+		text += " ";
+
+		for (uint32_t rank = 0; rank < p.versionCount; )
+		{
+			if (!versions.contains(rank))
+			{
+				++rank;
+				continue;
+			}
+
+			uint32_t last = rank;
+
+			while (last + 1 < p.versionCount && versions.contains(last + 1))
+				++last;
+
+			if (text.back() != ' ')
+				text += " || ";
+
+			text += p.ranked[rank]->toString();
+
+			if (last != rank)
+				text += " - " + p.ranked[last]->toString();
+
+			rank = last + 1;
+		}
+
+		return text;
+	}
+
+	std::string Resolver::describe(uint32_t incompatibility) const
+	{
+		const Incompatibility& i = incompatibilities[incompatibility];
+
+		switch (i.cause)
+		{
+		case Cause::ROOT:
+			return "root is required";
+
+		case Cause::DEPENDENCY:
+		{
+			const Package& p = packages[i.left];
+			const Dependency& d = p.dependencies[i.right][i.dependency];
+			std::string text = (i.left == sRoot ? std::string("root") : p.name + " " + p.ranked[i.right]->toString());
+
+			for (const Term& t : i.terms) // all versions that share the dependency
+			{
+				if (t.package != i.left || i.left == sRoot || i.left == d.package)
+					continue;
+
+				text = (t.set.size() == p.versionCount && p.versionCount > 1) ? "every version of " + p.name : describe(t);
+			}
+
+			text += " depends on " + d.text;
+
+			if (d.allowed.size() == 0)
+				text += ", which matches no versions";
+
+			return text;
+		}
+
+		default:
+			break;
+		}
+
+		if (i.terms.empty() || (i.terms.size() == 1 && i.terms[0].package == sRoot))
+			return "version solving failed";
+
+		if (i.terms.size() == 1)
+			return describe(i.terms[0]) + (i.terms[0].set.none ? " is required" : " is forbidden");
+
+		if (i.terms.size() == 2 && i.terms[0].set.none != i.terms[1].set.none)
+		{
+			const Term& positive = i.terms[0].set.none ? i.terms[1] : i.terms[0];
+			const Term& negative = i.terms[0].set.none ? i.terms[0] : i.terms[1];
+			return describe(positive) + " requires " + describe(Term{ negative.package, negative.set.complement() });
+		}
+
+		std::string text;
+
+		for (const Term& t : i.terms)
+			text += (text.empty() ? "" : " and ") + describe(t);
+
+		return text + " are incompatible";
+	}
+
+	std::string Resolver::explainConflict() const
+	{
+		if (failure < 0)
+			return {};
+
+		if (incompatibilities[failure].cause != Cause::DERIVED) // failed without any conflict to resolve
+			return "Because " + describe(static_cast<uint32_t>(failure)) + ", version solving failed.\n";
+
+		std::string text;
+		std::vector<bool> explained(incompatibilities.size(), false);
+		std::vector<std::pair<uint32_t, bool>> stack{ { static_cast<uint32_t>(failure), false } }; // post order: causes first
+
+		while (!stack.empty())
+		{
+			auto [incompatibility, causesDone] = stack.back();
+			stack.pop_back();
+
+			const Incompatibility& i = incompatibilities[incompatibility];
+
+			if (explained[incompatibility] || i.cause != Cause::DERIVED)
+				continue;
+
+			if (!causesDone)
+			{
+				stack.push_back({ incompatibility, true });
+				stack.push_back({ i.right, false });
+				stack.push_back({ i.left, false });
+				continue;
+			}
+
+			explained[incompatibility] = true;
+			text += "Because " + describe(i.left) + " and " + describe(i.right) + ", " + describe(incompatibility) + ".\n";
+		}
+
+		return text;
+	}
+
+}
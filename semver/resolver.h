@@ -0,0 +1,168 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include "range.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace semver
+{
+	// A set of versions of one package, by rank (position in ascending precedence), that can also include
+	// not selecting the package at all. Sets over the known versions of a package make intersection, union
+	// and complement exact, whatever ranges the queries that produced them had
+	struct VersionSet
+	{
+		std::vector<uint64_t> bits;
+		uint32_t count = 0; // versions of the package
+		bool none = false; // includes not selecting the package
+
+		static VersionSet empty(uint32_t count);
+		static VersionSet all(uint32_t count); // any version, or none
+		static VersionSet single(uint32_t count, uint32_t rank);
+
+		bool contains(uint32_t rank) const { return (bits[rank / 64] >> (rank % 64)) & 1; }
+		void insert(uint32_t rank) { bits[rank / 64] |= 1ull << (rank % 64); }
+
+		size_t size() const; // versions, not counting none
+		bool isEmpty() const;
+		bool isAll() const;
+		int64_t highest() const; // -1 if there are no versions
+
+		VersionSet& intersect(const VersionSet& other);
+		VersionSet& unite(const VersionSet& other);
+		VersionSet complement() const;
+		bool isSubsetOf(const VersionSet& other) const;
+		bool isDisjoint(const VersionSet& other) const;
+
+		bool operator==(const VersionSet& other) const = default;
+	};
+
+	// Finds a version for every package reachable from the requirements, such that all dependencies of the selected
+	// versions are met. Conflict driven in the style of PubGrub: conflicts are learned as incompatibilities, so the same
+	// dead end is never explored twice, and the incompatibilities that proved a graph unsolvable explain why
+	class Resolver
+	{
+	public:
+
+		bool addPackage(std::string_view name, const Version* const* versions, size_t count); // versions are referenced, not copied
+		bool addDependency(std::string_view name, size_t versionIndex, std::string_view dependency, const RangeSet& ranges);
+		void require(std::string_view name, const RangeSet& ranges);
+
+		bool solve();
+
+		struct Selection
+		{
+			const std::string* name;
+			const Version* version;
+		};
+
+		const std::vector<Selection>& solution() const { return selected; }
+		const Version* selectedVersion(std::string_view name) const;
+		std::string explainConflict() const; // empty unless the last solve failed
+
+		Resolver();
+		Resolver(const Resolver&) = delete;
+		Resolver& operator=(const Resolver&) = delete;
+		~Resolver();
+
+	private:
+
+		static constexpr uint32_t sRoot = 0; // package with a single version that depends on the requirements
+
+		struct Dependency
+		{
+			uint32_t package;
+			RangeSet ranges; // clones
+			std::string text;
+			VersionSet allowed; // versions of package matching ranges, computed per solve
+			bool computed = false;
+			bool added = false; // its incompatibility is kept when backtracking, so it is added once per solve
+		};
+
+		struct Package
+		{
+			std::string name;
+			bool defined = false;
+			uint32_t versionCount = 0;
+			std::vector<const Version*> ranked; // ascending
+			std::vector<uint32_t> rankOfIndex; // index as added -> rank
+			std::vector<std::vector<Dependency>> dependencies; // by rank
+
+			// solver state
+			std::vector<uint32_t> assignments;
+			VersionSet current; // intersection of assignments
+			int64_t decided = -1; // rank
+			uint32_t conflicts = 0; // packages that keep conflicting are decided first
+			std::vector<uint32_t> incompatibilities;
+		};
+
+		struct Term
+		{
+			uint32_t package;
+			VersionSet set; // the term is satisfied when the package's selection is in this set
+		};
+
+		enum class Cause : uint8_t
+		{
+			ROOT, // the root must be selected
+			DEPENDENCY,
+			DERIVED, // from two other incompatibilities during conflict resolution
+		};
+
+		struct Incompatibility // terms that can not all be satisfied at once
+		{
+			std::vector<Term> terms;
+			Cause cause;
+			uint32_t left = 0; // DEPENDENCY: package; DERIVED: incompatibility
+			uint32_t right = 0; // DEPENDENCY: rank; DERIVED: incompatibility
+			uint32_t dependency = 0; // DEPENDENCY: index in the package's dependencies of rank
+		};
+
+		struct Assignment
+		{
+			uint32_t package;
+			VersionSet set;
+			uint32_t level;
+			int64_t cause; // incompatibility it was derived from, -1 for decisions
+		};
+
+		enum class Relation : uint8_t
+		{
+			SATISFIED,
+			CONTRADICTED,
+			INCONCLUSIVE,
+		};
+
+		std::vector<Package> packages;
+		std::unordered_map<std::string, uint32_t> packageIndex;
+
+		std::vector<Incompatibility> incompatibilities;
+		std::vector<Assignment> assignments;
+		uint32_t level = 0;
+		int64_t failure = -1;
+		uint64_t conflictCount = 0;
+		std::vector<Selection> selected;
+
+		uint32_t packageFor(std::string_view name); // adds an undefined package for unknown names
+
+		const VersionSet& allowedBy(Dependency& dependency);
+		uint32_t addIncompatibility(std::vector<Term> terms, Cause cause, uint32_t left, uint32_t right, uint32_t dependency = 0);
+		void registerIncompatibility(uint32_t incompatibility);
+
+		Relation relation(const Term& term) const;
+		void assign(uint32_t package, VersionSet set, int64_t cause);
+		void backtrack(uint32_t toLevel);
+		int64_t satisfier(const Term& term) const;
+
+		bool propagate(uint32_t package);
+		int64_t propagateIncompatibility(uint32_t incompatibility, bool& conflict); // returns the package of a derived assignment, or -1
+		int64_t resolveConflict(uint32_t incompatibility); // returns the incompatibility to backtrack with, or -1 on failure
+		int64_t decide(); // returns the package decided (or found unsatisfiable), -1 when all are decided
+
+		std::string describe(const Term& term) const;
+		std::string describe(uint32_t incompatibility) const;
+	};
+
+}
@@ -1,13 +1,23 @@
 ﻿// Copyright 2025 Jasper Schellingerhout. All rights reserved.
 
 #include "semver.h"
+#include "block_memory.h"
 #include "version.h"
 #include "range.h"
+#include "query_index.h"
+#include "query_watch.h"
+#include "range_algebra.h"
+#include "resolver.h"
+#include "trace.h"
 #include <cstring>
 #include <vector>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
+#include <queue>
 #include <algorithm>
+#include <bit>
+#include <numeric>
 
 
 
@@ -39,12 +49,64 @@ SEMVER_API SemverParseResult semver_version_parse(HSemverVersion version, const
 // version array constructors
 /////////////////////////////
 
+// storage of blocks that can be appended to. Versions live in chunks that are never moved or freed 
+// while the block exists, so Version pointers (and reference blocks) stay valid as the block grows
+struct GrowableVersions
+{
+	static constexpr size_t sMinChunkCapacity = 16;
+
+	struct Chunk
+	{
+		semver::Version* versions;
+		size_t capacity;
+	};
+
+	std::vector<Chunk> chunks;
+	size_t lastChunkCount = 0;
+	std::vector<semver::Version*> ordered; // the block order, sorted blocks insert by binary search
+
+	semver::Version* nextSlot()
+	{
+		if (chunks.empty() || lastChunkCount == chunks.back().capacity)
+		{
+			size_t capacity = chunks.empty() ? sMinChunkCapacity : ordered.size(); // doubles the total capacity
+			addChunk(capacity);
+		}
+
+		return &chunks.back().versions[lastChunkCount++];
+	}
+
+	void addChunk(size_t capacity)
+	{
+		auto* versions = static_cast<semver::Version*>(::operator new(sizeof(semver::Version) * capacity));
+		memset(versions, 0, sizeof(semver::Version) * capacity);
+
+		for (size_t i = 0; i < capacity; ++i)
+			versions[i].flags |= semver::Version::Flags::MANAGED;
+
+		chunks.push_back({ versions, capacity });
+		lastChunkCount = 0;
+	}
+
+	~GrowableVersions()
+	{
+		for (semver::Version* v : ordered)
+			v->deleteHeapResources();
+
+		for (Chunk& chunk : chunks)
+			::operator delete(chunk.versions);
+	}
+};
+
+struct VersionBlockPrefixIndex;
+
 struct alignas(alignof(semver::Version)) SemverVersionBlock
 {
 	enum class VersionOwnership : uint32_t // also serve as magic numbers to ensure pointers passed to the API originated from us
 	{
 		OWNS       = 0xed3d995e,
-		REFERENCES  = 0xde3d995e  // first to hex values exchanged
+		REFERENCES  = 0xde3d995e, // first to hex values exchanged
+		GROWS      = 0xe63d995e   // owns its versions through GrowableVersions
 	};
 
 
@@ -66,6 +128,7 @@ struct alignas(alignof(semver::Version)) SemverVersionBlock
 		{ 
 		case(VersionOwnership::OWNS):
 		case(VersionOwnership::REFERENCES):
+		case(VersionOwnership::GROWS):
 			return version_block;
 		default:
 			return getEmptyBlockPointer();
@@ -74,16 +137,21 @@ struct alignas(alignof(semver::Version)) SemverVersionBlock
 	}
 
 
-	VersionOwnership ownership; //must match one of the two magic numbers
+	VersionOwnership ownership; //must match one of the magic numbers
 	SemverOrder order;
-	uint8_t reserved[3]; // explicit padding
+	bool mapped; // owned versions on pages of their own, see semver::memory::allocateMapped
+	uint8_t reserved[2]; // explicit padding
 	size_t count;
 	SemverVersionBlock* owner; // must have VersionOwnership::OWNED or be nullptr
+	SemverVersionBlock* prevRef; // references: the previous reference block of the owner, the owner for the first one
+	SemverVersionBlock* nextRef; // owners: their first reference block, references: the next one of the owner
+	VersionBlockPrefixIndex* index; // opt in, see semver_versions_index. Freed with the block
 
 	union
 	{
 		semver::Version versions[1];     // empty flexible variable array [] is supported in visual studio only 
 		semver::Version* versionPtrs[5]; // variable, but since versions are 40 bytes I might as well make this 5 so debugging is easiwer
+		GrowableVersions* growable;
 	};
 
 
@@ -97,6 +165,9 @@ struct alignas(alignof(semver::Version)) SemverVersionBlock
 		case(VersionOwnership::REFERENCES):
 			return versionPtrs[index];
 
+		case(VersionOwnership::GROWS):
+			return growable->ordered[index];
+
 		default:
 			return nullptr;
 		}
@@ -105,19 +176,90 @@ struct alignas(alignof(semver::Version)) SemverVersionBlock
 	SemverVersionBlock(size_t count, SemverVersionBlock* owner = nullptr) 
 		: ownership( owner ? VersionOwnership::REFERENCES : VersionOwnership::OWNS), 
 		order(SEMVER_ORDER_AS_GIVEN),
+		mapped(false),
 		owner(owner),
-		count(count) {};
+		count(count),
+		prevRef(nullptr),
+		nextRef(nullptr),
+		index(nullptr) {};
 
 };
 
-static std::unordered_map<SemverVersionBlock*, std::vector<SemverVersionBlock*>> sVersionBlockRefs;
 
+struct StartEndIndex
+{
+	size_t startIndex;
+	size_t endIndex; // one past the last
+};
+
+// where each major and each major.minor starts in a sorted block, so searches only need to look within one major.minor
+struct VersionBlockPrefixIndex
+{
+	struct MajorEntry
+	{
+		uint64_t major;
+		size_t firstMinor; // index in minors
+	};
+
+	struct MinorEntry
+	{
+		uint64_t minor;
+		size_t start; // index in the block
+	};
+
+	SemverOrder order;
+	std::vector<MajorEntry> majors; // in block order, ends with a sentinel
+	std::vector<MinorEntry> minors; // in block order, ends with a sentinel starting at count
+
+	// PRE: block is sorted
+	explicit VersionBlockPrefixIndex(const SemverVersionBlock& b)
+		: order(b.order)
+	{
+		for (size_t i = 0; i < b.count; ++i)
+		{
+			const semver::Version& v = *b.getVersionPtrAt(i);
+			bool newMajor = majors.empty() || majors.back().major != v.major;
+
+			if (newMajor)
+				majors.push_back({ v.major, minors.size() });
+
+			if (newMajor || minors.back().minor != v.minor)
+				minors.push_back({ v.minor, i });
+		}
+
+		majors.push_back({ 0, minors.size() });
+		minors.push_back({ 0, b.count });
+	}
+
+	bool before(uint64_t a, uint64_t b) const { return (order == SEMVER_ORDER_ASC) ? (a < b) : (a > b); }
+
+	// the versions with major.minor, or an empty slice where they would be
+	StartEndIndex slice(uint64_t major, uint64_t minor) const
+	{
+		auto majorsEnd = majors.end() - 1;
+		auto m = std::lower_bound(majors.begin(), majorsEnd, major, [this](const MajorEntry& e, uint64_t major) { return before(e.major, major); });
+
+		if (m == majorsEnd || m->major != major)
+		{
+			size_t at = minors[m->firstMinor].start;
+			return { at, at };
+		}
+
+		auto minorsEnd = minors.begin() + (m + 1)->firstMinor;
+		auto n = std::lower_bound(minors.begin() + m->firstMinor, minorsEnd, minor, [this](const MinorEntry& e, uint64_t minor) { return before(e.minor, minor); });
+
+		if (n == minorsEnd || n->minor != minor)
+			return { n->start, n->start };
+
+		return { n->start, (n + 1)->start };
+	}
+};
 
 static_assert(offsetof(SemverVersionBlock, ownership) == 0, "ownership offset mismatch");
 static_assert(offsetof(SemverVersionBlock, count) == 8, "count offset mismatch");
 static_assert(offsetof(SemverVersionBlock, owner) == 16, "union offset mismatch");
-static_assert(offsetof(SemverVersionBlock, versions) == 24, "union offset mismatch");
-static_assert(sizeof(SemverVersionBlock) == 64, "Unexpected struct size"); // with flexible array it was only 32 (24 + some bogus 8 byte padding). With single entry its 64 (Version is 40 bytes)
+static_assert(offsetof(SemverVersionBlock, versions) == 48, "union offset mismatch");
+static_assert(sizeof(SemverVersionBlock) == 88, "Unexpected struct size"); // 48 byte header and a single entry (Version is 40 bytes)
 
 static_assert(std::is_trivially_copyable<semver::Version*>::value, "Version* must be trivially copyable");
 static_assert(alignof(SemverVersionBlock) >= alignof(semver::Version), "Block alignment must support embedded Version");
@@ -126,7 +268,9 @@ static_assert(offsetof(SemverVersionBlock, versions) == offsetof(SemverVersionBl
 
 const SemverVersionBlock SemverVersionBlock::sEmpty = SemverVersionBlock{ 0, nullptr };
 
-static SemverVersionBlock* createVersionBlock(size_t count)
+static SemverAllocation sBlockAllocation{ FALSE, -1 }; // see semver_versions_set_allocation
+
+static SemverVersionBlock* createVersionBlock(size_t count, int numaNode = sBlockAllocation.numa_node)
 {
 	if (count == 0)
 		return SemverVersionBlock::getEmptyBlockPointer(); // all empty blocks share a single empty block pointer 
@@ -134,10 +278,17 @@ static SemverVersionBlock* createVersionBlock(size_t count)
 	size_t versionsSize = sizeof(semver::Version) * count;
 	size_t totalSize = sizeof(SemverVersionBlock) - sizeof(semver::Version) + versionsSize; //one version size already counted
 
-	auto* block = static_cast<SemverVersionBlock*>(::operator new(totalSize));
+	semver::stats::count(semver::stats::BLOCKS_CREATED);
+	void* memory = nullptr;
+
+	if ((sBlockAllocation.huge_pages || numaNode >= 0) && totalSize >= semver::memory::minMappedSize)
+		memory = semver::memory::allocateMapped(totalSize, sBlockAllocation.huge_pages, numaNode);
+
+	auto* block = static_cast<SemverVersionBlock*>(memory ? memory : ::operator new(totalSize));
 	
 	new (block) SemverVersionBlock{ count, nullptr }; // use memory at start of block
-	memset(&block->versions, 0, versionsSize); // Versions with all 0s
+	block->mapped = memory != nullptr;
+	memset(&block->versions, 0, versionsSize); // Versions with all 0s, which also places the pages of mapped blocks
 
 	for (size_t i = 0; i < block->count; ++i)
 		block->versions[i].flags |= semver::Version::Flags::MANAGED;
@@ -145,30 +296,189 @@ static SemverVersionBlock* createVersionBlock(size_t count)
 	return block;
 }
 
+// PRE: block owns its versions and is not the shared empty block
+static void freeVersionBlock(SemverVersionBlock* block)
+{
+	if (block->mapped)
+		semver::memory::freeMapped(block);
+	else
+		::operator delete(block);
+}
+
+static SemverVersionBlock* createGrowableVersionBlock(size_t capacity, SemverOrder order)
+{
+	semver::stats::count(semver::stats::BLOCKS_CREATED);
+	auto* block = static_cast<SemverVersionBlock*>(::operator new(sizeof(SemverVersionBlock)));
+	new (block) SemverVersionBlock{ 0, nullptr };
+
+	block->ownership = SemverVersionBlock::VersionOwnership::GROWS;
+	block->order = order;
+	block->growable = new GrowableVersions();
+	block->growable->addChunk(std::max(capacity, GrowableVersions::sMinChunkCapacity));
+	block->growable->ordered.reserve(capacity);
+
+	return block;
+}
+
+// Reference blocks (query results, sorted and unique views) of up to sMaxCapacity pointers are allocated in classes
+// of 8, 16, ... pointers and kept per thread once disposed, so creating and disposing results rarely reaches the heap.
+// A block disposed on another thread than it was created on joins the pool of that thread
+struct ReferenceBlockPool
+{
+	static constexpr size_t sMinCapacity = 8;
+	static constexpr size_t sClassCount = 7;
+	static constexpr size_t sMaxCapacity = sMinCapacity << (sClassCount - 1); // 512
+	static constexpr size_t sMaxFree = 32; // per class, the rest goes back to the heap
+
+	SemverVersionBlock* free[sClassCount] = {}; // linked through nextRef
+	size_t freeCount[sClassCount] = {};
+
+	static size_t classOf(size_t count) { return (count <= sMinCapacity) ? 0 : std::bit_width(count - 1) - std::bit_width(sMinCapacity - 1); }
+
+	static size_t bytesFor(size_t capacity)
+	{
+		size_t totalSize = sizeof(SemverVersionBlock) - sizeof(semver::Version) + sizeof(semver::Version*) * capacity; //union has the size of Version
+		return std::max(totalSize, sizeof(SemverVersionBlock)); // at least what sizeof expects
+	}
+
+	// PRE: count > 0
+	SemverVersionBlock* allocate(size_t count)
+	{
+		if (count > sMaxCapacity)
+			return static_cast<SemverVersionBlock*>(::operator new(bytesFor(count)));
+
+		size_t c = classOf(count);
+		SemverVersionBlock* block = free[c];
+
+		if (!block)
+			return static_cast<SemverVersionBlock*>(::operator new(bytesFor(sMinCapacity << c)));
+
+		free[c] = block->nextRef;
+		--freeCount[c];
+		return block;
+	}
+
+	// the count of a reference block never changes, so it still gives the class it was allocated for
+	void release(SemverVersionBlock* block)
+	{
+		size_t c = classOf(block->count);
+
+		if (block->count > sMaxCapacity || freeCount[c] == sMaxFree)
+		{
+			::operator delete(block);
+			return;
+		}
+
+		block->nextRef = free[c];
+		free[c] = block;
+		++freeCount[c];
+	}
+
+	~ReferenceBlockPool()
+	{
+		for (SemverVersionBlock* block : free)
+		{
+			while (block)
+			{
+				SemverVersionBlock* next = block->nextRef;
+				::operator delete(block);
+				block = next;
+			}
+		}
+	}
+};
+
+static thread_local ReferenceBlockPool tReferenceBlockPool;
+
 static SemverVersionBlock* createVersionReferenceBlock(SemverVersionBlock* owner, size_t count)
 {
 	if (count == 0)
 		return SemverVersionBlock::getEmptyBlockPointer(); // all empty blocks share a single empty block pointer 
 
-	size_t versionRefsSize = sizeof(semver::Version*) * count;
-	size_t totalSize = sizeof(SemverVersionBlock) - sizeof(semver::Version) + versionRefsSize; //union has since of Version
-
-	if (totalSize < sizeof(SemverVersionBlock))
-		totalSize = sizeof(SemverVersionBlock); // if we have fewer the 5 pointers (Version is 40 bytes) we probably want to allocate at least what sizeof expects
-
-	auto* block = static_cast<SemverVersionBlock*>(::operator new(totalSize));
+	semver::stats::count(semver::stats::BLOCKS_CREATED);
+	auto* block = tReferenceBlockPool.allocate(count);
 	new (block) SemverVersionBlock{ count, owner }; 
 
 	std::fill_n(block->versionPtrs, count, nullptr); //all pointers set to null
-	
-	sVersionBlockRefs[owner].push_back(block);
 
+	// first in the list of the owner, disposed with it unless disposed earlier
+	block->prevRef = owner;
+	block->nextRef = owner->nextRef;
+
+	if (owner->nextRef)
+		owner->nextRef->prevRef = block;
+
+	owner->nextRef = block;
 
 	return block;
 
 }
 
 
+// PRE: block owns its versions, newCapacity >= count. Returns the new block, the old one is freed
+static SemverVersionBlock* growVersionBlock(SemverVersionBlock* block, size_t count, size_t newCapacity)
+{
+	SemverVersionBlock* grown = createVersionBlock(newCapacity);
+
+	for (size_t i = 0; i < count; ++i)
+		block->versions[i].moveTo(grown->versions[i]);
+
+	grown->order = block->order;
+
+	if (block->count != 0) // don't free the shared empty block
+		freeVersionBlock(block);
+
+	return grown;
+}
+
+static void sortVersions(semver::Version* versions, size_t count, SemverOrder order)
+{
+	if (order == SEMVER_ORDER_AS_GIVEN || count < 2)
+		return;
+
+	semver::stats::count(semver::stats::BLOCK_SORTS);
+	semver::trace::Span sort(SEMVER_TRACE_SORT, count);
+	sort.setResult(count, 0);
+
+	auto precedes = [order](const semver::Version& a, const semver::Version& b)
+		{
+			int comp = semver::Version::compare(a, b);
+			return (order == SEMVER_ORDER_ASC) ? (comp < 0) : (comp > 0);
+		};
+
+	bool hasBuilds = std::any_of(versions, versions + count, [](const semver::Version& v) { return v.hasBuild(); });
+
+	if (!hasBuilds)
+	{
+		std::sort(versions, versions + count, precedes);
+		return;
+	}
+
+	// builds are keyed on the Version address, so they have to travel with the Version while sorting
+	struct VersionWithBuild
+	{
+		semver::Version version;
+		const char* build;
+	};
+
+	std::vector<VersionWithBuild> sortable(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		sortable[i].build = versions[i].detachBuild();
+		sortable[i].version = versions[i];
+	}
+
+	std::sort(sortable.begin(), sortable.end(), 
+		[&precedes](const VersionWithBuild& a, const VersionWithBuild& b) { return precedes(a.version, b.version); });
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		versions[i] = sortable[i].version;
+		versions[i].attachBuild(sortable[i].build);
+	}
+}
+
 static std::vector<std::string_view> splitMultistringBuffer(const char* buffer)
 {
 	std::vector<std::string_view> tokens;
@@ -213,29 +523,38 @@ SEMVER_API HSemverVersions semver_versions_from_string(const char* versions_str,
 	if (!versions_str)
 		return reinterpret_cast<HSemverVersions>(SemverVersionBlock::getEmptyBlockHandle());
 
-	std::vector<std::string_view> versionStrs = (!separator || *separator == '\0') ? splitMultistringBuffer(versions_str) : splitBuffer(versions_str, separator);
+	std::vector<std::string_view> versionStrs;
+	size_t bytes = 0; // up to the end of the last version string, only measured when tracing
+
+	{
+		semver::trace::Span split(SEMVER_TRACE_SPLIT);
+		versionStrs = (!separator || *separator == '\0') ? splitMultistringBuffer(versions_str) : splitBuffer(versions_str, separator);
+
+		if (split.active() && !versionStrs.empty())
+			bytes = versionStrs.back().data() + versionStrs.back().size() - versions_str;
+
+		split.setResult(versionStrs.size(), bytes);
+	}
 
 	size_t count = versionStrs.size();
 
 
 	SemverVersionBlock* block = createVersionBlock(count);
 
-	for (size_t i = 0; i < count; ++i)
-		block->versions[i].parse(versionStrs[i].data(), versionStrs[i].size());
-
-	if (order != SEMVER_ORDER_AS_GIVEN)
 	{
-		std::sort(block->versions, block->versions + count, 
-			[order](const semver::Version& a, const semver::Version& b) 
-			{
-				int comp = semver::Version::compare(a, b);
-				return (order == SEMVER_ORDER_ASC) ? (comp < 0) : (comp > 0);
-			}
-		);
+		semver::trace::Span parse(SEMVER_TRACE_PARSE, count, bytes);
+
+		for (size_t i = 0; i < count; ++i)
+			block->versions[i].parse(versionStrs[i].data(), versionStrs[i].size());
 
+		parse.setResult(count, bytes);
 	}
 
-	block->order = order;
+	if (count != 0)
+	{
+		sortVersions(block->versions, count, order);
+		block->order = order;
+	}
 
 	return reinterpret_cast<HSemverVersions>(block);
 }
@@ -246,137 +565,608 @@ SEMVER_API HSemverVersions semver_versions_create(size_t count)
 	return reinterpret_cast<HSemverVersions>(block);
 }
 
-// query constructor
-////////////////////
-
-SEMVER_API HSemverQuery semver_query_create()
+SEMVER_API void semver_versions_set_allocation(const SemverAllocation* allocation)
 {
-	semver::Query* q = new semver::Query();
-	return reinterpret_cast<HSemverQuery>(q);
+	sBlockAllocation = allocation ? *allocation : SemverAllocation{ FALSE, -1 };
 }
 
-
-SEMVER_API SemverQueryParseResult semver_query_parse(HSemverQuery query, const char* query_str)
+SEMVER_API int semver_current_numa_node()
 {
-	return reinterpret_cast<semver::Query*>(query)->parse(query_str, semver::strlenSafe(query_str));
+	return semver::memory::currentNode();
 }
 
-// destructors
-//////////////////////////////
-
-SEMVER_API void semver_version_dispose(HSemverVersion version) // Free the allocated version object
+SEMVER_API HSemverVersions semver_versions_replicate(const HSemverVersions version_array, int numa_node)
 {
-	semver::Version* v = reinterpret_cast<semver::Version*>(version);
-	
-	if (v->flags & semver::Version::Flags::MANAGED)
-		return;  // block or range boundary will take care of it (maybe we can just do deleteHeapResources, but definitely not delete)
+	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(version_array);
+	SemverVersionBlock* replica = createVersionBlock(b->count, numa_node);
 
-	v->deleteHeapResources();
-	delete v;
+	for (size_t i = 0; i < b->count; ++i)
+		replica->versions[i].copyFrom(*b->getVersionPtrAt(i));
+
+	if (replica->count != 0) // not the shared empty block
+		replica->order = b->order;
+
+	return reinterpret_cast<HSemverVersions>(replica);
 }
 
-static void DisposeSemverVersionBlockHeapResources(SemverVersionBlock* block)
+SEMVER_API HSemverVersions semver_versions_create_growable(size_t capacity, SemverOrder order)
 {
+	return reinterpret_cast<HSemverVersions>(createGrowableVersionBlock(capacity, order));
+}
 
-	if (block->count != 0) // all empty blocks share the same static block which is not disposed
-	{
+SEMVER_API HSemverVersion semver_versions_append(HSemverVersions version_array, const char* version_str)
+{
+	SemverVersionBlock* block = SemverVersionBlock::pointerFromHandle(version_array);
 
-		if (block->ownership == SemverVersionBlock::VersionOwnership::OWNS)
-		{
-			for (size_t i = 0; i < block->count; ++i)
-				block->versions[i].deleteHeapResources(); // don't delete the version pointer! The block holds the data
-		}
+	if (block->ownership != SemverVersionBlock::VersionOwnership::GROWS)
+		return nullptr;
 
-		::operator delete(block);
+	GrowableVersions& storage = *block->growable;
+	semver::Version* v = storage.nextSlot();
+	v->parse(version_str, semver::strlenSafe(version_str));
+
+	auto& ordered = storage.ordered;
+
+	if (block->order == SEMVER_ORDER_AS_GIVEN)
+		ordered.push_back(v);
+	else
+	{
+		auto precedes = [order = block->order](const semver::Version* a, const semver::Version* b)
+			{
+				int comp = semver::Version::compare(*a, *b);
+				return (order == SEMVER_ORDER_ASC) ? (comp < 0) : (comp > 0);
+			};
+
+		ordered.insert(std::upper_bound(ordered.begin(), ordered.end(), v, precedes), v); // after equal versions, like appending
 	}
 
+	block->count = ordered.size();
+	delete block->index; // positions moved
+	block->index = nullptr;
+
+	return reinterpret_cast<HSemverVersion>(v);
 }
 
-SEMVER_API void semver_versions_dispose(HSemverVersions version_array)
+// version array streaming constructor
+//////////////////////////////////////
+
+struct SemverVersionsStream
 {
-	SemverVersionBlock* version_block = SemverVersionBlock::pointerFromHandle(version_array);
+	std::string separator; // "\0" for multistrings
+	std::string carry; // unfinished token (and possibly part of a separator) from the end of the previous chunk
+	bool terminated; // multistrings end at an empty string
 
-	if (version_block->ownership == SemverVersionBlock::VersionOwnership::REFERENCES)
+	SemverVersionBlock* block;
+	size_t count; // block->count is the capacity while streaming
+
+	static constexpr size_t sInitialCapacity = 64;
+
+	void addVersion(const char* str, size_t len)
+	{
+		if (count == block->count)
+			block = growVersionBlock(block, count, count ? count * 2 : sInitialCapacity);
+
+		block->versions[count++].parse(str, len);
+	}
+
+	void addToken(const char* str, size_t len)
+	{
+		if (len == 0 && separator.size() == 1 && separator[0] == '\0')
+			terminated = true; // double \0 ends a multistring
+		else
+			addVersion(str, len);
+	}
+
+	// returns the position in buf just past a separator that started in carry, or 0 if there is none
+	size_t completeCarrySeparator(const char* buf, size_t len)
 	{
-		if (version_block->owner) //we expect this for blocks holding refs only
+		size_t sepLen = separator.size();
+		size_t tail = std::min(carry.size(), sepLen - 1);
+
+		for (size_t k = carry.size() - tail; k < carry.size(); ++k)
 		{
-			auto it = sVersionBlockRefs.find(version_block->owner);
-			if (it != sVersionBlockRefs.end()) // does this block have references? 
-			{
-				auto& blockRefs = it->second;
+			size_t inCarry = carry.size() - k;
+			size_t inBuf = sepLen - inCarry;
 
-				if (std::erase(blockRefs, version_block) && (blockRefs.size() == 0))
-					sVersionBlockRefs.erase(version_block->owner);
+			if (len >= inBuf &&
+				carry.compare(k, inCarry, separator, 0, inCarry) == 0 &&
+				memcmp(buf, separator.data() + inCarry, inBuf) == 0)
+			{
+				addToken(carry.data(), k);
+				carry.clear();
+				return inBuf;
 			}
-
 		}
+
+		return 0;
 	}
-	else // it owns the versions and may have reference lists
+
+	void feed(const char* buf, size_t len)
 	{
+		std::string_view chunk(buf, len);
+		size_t pos = 0;
+
+		if (!carry.empty())
+		{
+			pos = completeCarrySeparator(buf, len);
 
-		auto it = sVersionBlockRefs.find(version_block);
-		if (it != sVersionBlockRefs.end()) // does this block have references? 
+			if (pos == 0)
+			{
+				size_t next = chunk.find(separator);
+
+				if (next == std::string_view::npos)
+				{
+					carry.append(buf, len); // a token longer than the chunk
+					return;
+				}
+
+				carry.append(buf, next);
+				addToken(carry.data(), carry.size());
+				carry.clear();
+				pos = next + separator.size();
+			}
+		}
+
+		while (pos < len && !terminated)
 		{
-			auto& blockRefs = it->second;
+			size_t next = chunk.find(separator, pos);
 
-			for (auto blockref : it->second)
-				DisposeSemverVersionBlockHeapResources(blockref);
+			if (next == std::string_view::npos)
+			{
+				carry.assign(buf + pos, len - pos);
+				break;
+			}
 
-			sVersionBlockRefs.erase(it); //it no longer valid beyond this
+			addToken(buf + pos, next - pos);
+			pos = next + separator.size();
 		}
-	} 
+	}
+};
+
+SEMVER_API HSemverVersionsStream semver_versions_stream_begin(const char* separator)
+{
+	SemverVersionsStream* stream = new SemverVersionsStream{};
 
+	if (!separator || *separator == '\0')
+		stream->separator.assign(1, '\0');
+	else
+		stream->separator = separator;
 
-	DisposeSemverVersionBlockHeapResources(version_block);
+	stream->block = SemverVersionBlock::getEmptyBlockPointer();
 
+	return reinterpret_cast<HSemverVersionsStream>(stream);
 }
 
-SEMVER_API void semver_query_dispose(HSemverQuery query)
+SEMVER_API void semver_versions_stream_feed(HSemverVersionsStream stream, const char* buf, size_t len)
 {
-	semver::Query* q = reinterpret_cast<semver::Query*>(query);
-	for (semver::Range& r : q->rangeSet) 
+	SemverVersionsStream* s = reinterpret_cast<SemverVersionsStream*>(stream);
+
+	if (buf && len > 0 && !s->terminated)
 	{
-		r.lower.juncture.deleteHeapResources();
-		r.upper.juncture.deleteHeapResources(); // while not technically allowed it is possible to add Build meta data so I don't just delete Prerelease heap resources
+		semver::trace::Span parse(SEMVER_TRACE_PARSE, 0, len); // the versions in a chunk are known once it is split
+		size_t before = s->count;
+		s->feed(buf, len);
+		parse.setResult(s->count - before, len);
 	}
-	delete q;
 }
 
+SEMVER_API HSemverVersions semver_versions_stream_finish(HSemverVersionsStream stream, SemverOrder order)
+{
+	SemverVersionsStream* s = reinterpret_cast<SemverVersionsStream*>(stream);
 
-// version array info
-/////////////////////
+	if (!s->carry.empty() && !s->terminated)
+		s->addToken(s->carry.data(), s->carry.size()); // last token has no separator after it
 
-SEMVER_API size_t semver_versions_count(HSemverVersions version_array)
-{
-	return SemverVersionBlock::pointerFromHandle(version_array)->count;
-}
+	SemverVersionBlock* block = s->block;
+	size_t count = s->count;
+	delete s;
 
-SEMVER_API HSemverVersion semver_versions_get_version_at_index(HSemverVersions version_array, size_t index)
-{
-	SemverVersionBlock* version_block = SemverVersionBlock::pointerFromHandle(version_array);
+	if (count == 0)
+		return SemverVersionBlock::getEmptyBlockHandle(); // never grew, so this is already the shared empty block
 
-   return reinterpret_cast<HSemverVersion>(version_block->getVersionPtrAt(index));
+	if (block->count - count > count / 4)
+		block = growVersionBlock(block, count, count); // give back excess capacity
 
+	block->count = count;
+	sortVersions(block->versions, count, order);
+	block->order = order;
 
+	return reinterpret_cast<HSemverVersions>(block);
 }
 
-// version info
-///////////////
+// version array merge
+//////////////////////
 
-SEMVER_API uint64_t semver_get_version_major(const HSemverVersion version)
+// hashes what makes versions duplicates: precedence (core and prerelease) and optionally the build
+struct VersionDuplicateHash
 {
-	return reinterpret_cast<semver::Version*>(version)->major;
-}
+	bool includeBuild;
 
-SEMVER_API uint64_t semver_get_version_minor(const HSemverVersion version)
-{
-	return reinterpret_cast<semver::Version*>(version)->minor;
-}
+	size_t operator()(const semver::Version* v) const
+	{
+		size_t h = std::hash<std::string_view>{}(v->getPrerelease());
+		h ^= (v->major * 0x9E3779B97F4A7C15ull) ^ (v->minor * 0xC2B2AE3D27D4EB4Full) ^ (v->patch * 0x165667B19E3779F9ull);
 
-SEMVER_API uint64_t semver_get_version_patch(const HSemverVersion version)
+		if (includeBuild)
+			h ^= std::hash<std::string_view>{}(v->getBuild()) * 31;
+
+		return h;
+	}
+};
+
+struct VersionDuplicateEqual
 {
-	return reinterpret_cast<semver::Version*>(version)->patch;
-}
+	bool includeBuild;
+
+	bool operator()(const semver::Version* a, const semver::Version* b) const
+	{
+		return semver::Version::compare(*a, *b) == 0 && 
+			(!includeBuild || strcmp(a->getBuild(), b->getBuild()) == 0);
+	}
+};
+
+typedef std::unordered_set<const semver::Version*, VersionDuplicateHash, VersionDuplicateEqual> VersionDuplicateSet;
+
+static VersionDuplicateSet createVersionDuplicateSet(size_t expectedCount, SemverDedup dedup)
+{
+	bool includeBuild = dedup == SEMVER_DEDUP_PRECEDENCE_AND_BUILD;
+	return VersionDuplicateSet(expectedCount, VersionDuplicateHash{ includeBuild }, VersionDuplicateEqual{ includeBuild });
+}
+
+// passes versions arriving in sorted order, dropping duplicates of the versions already passed
+struct SortedDedupFilter
+{
+	SemverDedup dedup;
+	const semver::Version* last = nullptr;
+	std::vector<const semver::Version*> run = {}; // passed versions with the same precedence as last (only when deduping by build)
+
+	bool isDuplicate(const semver::Version& v) const
+	{
+		if (dedup == SEMVER_DEDUP_PRECEDENCE)
+			return true;
+
+		for (const semver::Version* passed : run) // builds within a run of equal precedence are in no particular order
+			if (strcmp(v.getBuild(), passed->getBuild()) == 0)
+				return true;
+
+		return false;
+	}
+
+	bool pass(const semver::Version& v)
+	{
+		if (dedup == SEMVER_DEDUP_NONE)
+			return true;
+
+		bool samePrecedence = last && semver::Version::compare(v, *last) == 0;
+
+		if (samePrecedence && isDuplicate(v))
+			return false;
+
+		if (dedup == SEMVER_DEDUP_PRECEDENCE_AND_BUILD)
+		{
+			if (!samePrecedence)
+				run.clear();
+
+			run.push_back(&v);
+		}
+
+		last = &v;
+		return true;
+	}
+};
+
+// walks a block in a given sort order, whatever order the block itself is in
+struct OrderedBlockCursor
+{
+	const SemverVersionBlock* block;
+	std::vector<const semver::Version*> sorted; // only for blocks that are not sorted
+	bool reversed = false;
+	size_t pos = 0;
+
+	OrderedBlockCursor(const SemverVersionBlock* block, SemverOrder order) 
+		: block(block)
+	{
+		if (block->order == order)
+			return;
+
+		if (block->order != SEMVER_ORDER_AS_GIVEN)
+		{
+			reversed = true; // sorted the other way
+			return;
+		}
+
+		sorted.resize(block->count);
+		for (size_t i = 0; i < block->count; ++i)
+			sorted[i] = block->getVersionPtrAt(i);
+
+		std::stable_sort(sorted.begin(), sorted.end(), [order](const semver::Version* a, const semver::Version* b)
+			{
+				int comp = semver::Version::compare(*a, *b);
+				return (order == SEMVER_ORDER_ASC) ? (comp < 0) : (comp > 0);
+			});
+	}
+
+	bool atEnd() const { return pos == block->count; }
+
+	const semver::Version* current() const
+	{
+		if (!sorted.empty())
+			return sorted[pos];
+
+		return block->getVersionPtrAt(reversed ? block->count - 1 - pos : pos);
+	}
+};
+
+SEMVER_API HSemverVersions semver_versions_merge(const HSemverVersions* version_arrays, size_t array_count, SemverOrder order, SemverDedup dedup)
+{
+	size_t total = 0;
+
+	for (size_t i = 0; i < array_count; ++i)
+		total += SemverVersionBlock::pointerFromHandle(version_arrays[i])->count;
+
+	if (total == 0)
+		return SemverVersionBlock::getEmptyBlockHandle();
+
+	SemverVersionBlock* result = createVersionBlock(total);
+	size_t count = 0;
+
+	if (order == SEMVER_ORDER_AS_GIVEN) // concatenate
+	{
+		VersionDuplicateSet seen = createVersionDuplicateSet(dedup == SEMVER_DEDUP_NONE ? 0 : total, dedup);
+
+		for (size_t i = 0; i < array_count; ++i)
+		{
+			SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(version_arrays[i]);
+
+			for (size_t j = 0; j < b->count; ++j)
+			{
+				const semver::Version* v = b->getVersionPtrAt(j);
+
+				if (dedup == SEMVER_DEDUP_NONE || seen.insert(v).second)
+					result->versions[count++].copyFrom(*v);
+			}
+		}
+	}
+	else // k-way merge of the sorted inputs
+	{
+		std::vector<OrderedBlockCursor> cursors;
+		cursors.reserve(array_count);
+
+		for (size_t i = 0; i < array_count; ++i)
+			cursors.emplace_back(SemverVersionBlock::pointerFromHandle(version_arrays[i]), order);
+
+		auto after = [&cursors, order](size_t a, size_t b) // priority_queue keeps the largest on top, so this is reversed
+			{
+				int comp = semver::Version::compare(*cursors[a].current(), *cursors[b].current());
+
+				if (comp == 0)
+					return a > b; // equal versions come from earlier blocks first
+
+				return (order == SEMVER_ORDER_ASC) ? (comp > 0) : (comp < 0);
+			};
+
+		std::priority_queue<size_t, std::vector<size_t>, decltype(after)> heads(after);
+
+		for (size_t i = 0; i < array_count; ++i)
+			if (!cursors[i].atEnd())
+				heads.push(i);
+
+		SortedDedupFilter filter{ dedup };
+
+		while (!heads.empty())
+		{
+			size_t i = heads.top();
+			heads.pop();
+
+			const semver::Version* v = cursors[i].current();
+
+			if (filter.pass(*v))
+				result->versions[count++].copyFrom(*v);
+
+			if (++cursors[i].pos, !cursors[i].atEnd())
+				heads.push(i);
+		}
+	}
+
+	result->count = count; // dropped duplicates leave unused (empty) versions at the end
+	result->order = order;
+
+	return reinterpret_cast<HSemverVersions>(result);
+}
+
+SEMVER_API HSemverVersions semver_versions_unique(const HSemverVersions version_array, SemverDedup dedup)
+{
+	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(version_array);
+	std::vector<semver::Version*> unique;
+	unique.reserve(b->count);
+
+	if (b->order == SEMVER_ORDER_AS_GIVEN && dedup != SEMVER_DEDUP_NONE) // duplicates can be anywhere
+	{
+		VersionDuplicateSet seen = createVersionDuplicateSet(b->count, dedup);
+
+		for (size_t i = 0; i < b->count; ++i)
+		{
+			semver::Version* v = b->getVersionPtrAt(i);
+
+			if (seen.insert(v).second)
+				unique.push_back(v);
+		}
+	}
+	else // duplicates are adjacent
+	{
+		SortedDedupFilter filter{ dedup };
+
+		for (size_t i = 0; i < b->count; ++i)
+		{
+			semver::Version* v = b->getVersionPtrAt(i);
+
+			if (filter.pass(*v))
+				unique.push_back(v);
+		}
+	}
+
+	if (unique.empty())
+		return SemverVersionBlock::getEmptyBlockHandle();
+
+	SemverVersionBlock* result = createVersionReferenceBlock(b->owner ? b->owner : b, unique.size()); // reference blocks don't own reference blocks
+	std::memcpy(result->versionPtrs, unique.data(), sizeof(semver::Version*) * unique.size());
+	result->order = b->order;
+
+	return reinterpret_cast<HSemverVersions>(result);
+}
+
+// query constructor
+////////////////////
+
+SEMVER_API HSemverQuery semver_query_create()
+{
+	semver::Query* q = new semver::Query();
+	return reinterpret_cast<HSemverQuery>(q);
+}
+
+
+SEMVER_API SemverQueryParseResult semver_query_parse(HSemverQuery query, const char* query_str)
+{
+	return reinterpret_cast<semver::Query*>(query)->parse(query_str, semver::strlenSafe(query_str));
+}
+
+// destructors
+//////////////////////////////
+
+SEMVER_API void semver_version_dispose(HSemverVersion version) // Free the allocated version object
+{
+	semver::Version* v = reinterpret_cast<semver::Version*>(version);
+	
+	if (v->flags & semver::Version::Flags::MANAGED)
+		return;  // block or range boundary will take care of it (maybe we can just do deleteHeapResources, but definitely not delete)
+
+	v->deleteHeapResources();
+	delete v;
+}
+
+static void DisposeSemverVersionBlockHeapResources(SemverVersionBlock* block)
+{
+	delete block->index;
+
+	if (block->ownership == SemverVersionBlock::VersionOwnership::GROWS) // may be empty, but is never the shared empty block
+	{
+		delete block->growable;
+		::operator delete(block);
+		return;
+	}
+
+	if (block->count != 0) // all empty blocks share the same static block which is not disposed
+	{
+
+		if (block->ownership == SemverVersionBlock::VersionOwnership::REFERENCES)
+		{
+			tReferenceBlockPool.release(block);
+			return;
+		}
+
+		for (size_t i = 0; i < block->count; ++i)
+			block->versions[i].deleteHeapResources(); // don't delete the version pointer! The block holds the data
+
+		freeVersionBlock(block);
+	}
+
+}
+
+SEMVER_API void semver_versions_dispose(HSemverVersions version_array)
+{
+	SemverVersionBlock* version_block = SemverVersionBlock::pointerFromHandle(version_array);
+
+	if (version_block->ownership == SemverVersionBlock::VersionOwnership::REFERENCES)
+	{
+		version_block->prevRef->nextRef = version_block->nextRef; // unlink from the owner
+		
+		if (version_block->nextRef)
+			version_block->nextRef->prevRef = version_block->prevRef;
+	}
+	else // it owns the versions and may have reference blocks
+	{
+		SemverVersionBlock* blockref = version_block->nextRef;
+
+		while (blockref)
+		{
+			SemverVersionBlock* next = blockref->nextRef;
+			DisposeSemverVersionBlockHeapResources(blockref);
+			blockref = next;
+		}
+	} 
+
+
+	DisposeSemverVersionBlockHeapResources(version_block);
+
+}
+
+SEMVER_API void semver_query_dispose(HSemverQuery query)
+{
+	semver::Query* q = reinterpret_cast<semver::Query*>(query);
+	for (semver::Range& r : q->rangeSet) 
+		r.deleteHeapResources(); // while not technically allowed it is possible to add Build meta data so I don't just delete Prerelease heap resources
+
+	delete q;
+}
+
+
+// version array info
+/////////////////////
+
+SEMVER_API size_t semver_versions_count(HSemverVersions version_array)
+{
+	return SemverVersionBlock::pointerFromHandle(version_array)->count;
+}
+
+SEMVER_API HSemverVersion semver_versions_get_version_at_index(HSemverVersions version_array, size_t index)
+{
+	SemverVersionBlock* version_block = SemverVersionBlock::pointerFromHandle(version_array);
+
+   return reinterpret_cast<HSemverVersion>(version_block->getVersionPtrAt(index));
+
+
+}
+
+SEMVER_API size_t semver_versions_format(const HSemverVersions version_array, const char* separator, char* buf, size_t cap)
+{
+	SemverVersionBlock* version_block = SemverVersionBlock::pointerFromHandle(version_array);
+
+	bool multistring = !separator || *separator == '\0'; // mirror semver_versions_from_string
+	size_t separatorLen = multistring ? 1 : strlen(separator);
+
+	semver::FormatBuffer out{ buf, cap };
+
+	for (size_t i = 0; i < version_block->count; ++i)
+	{
+		if (i > 0 && !multistring)
+			out.put(separator, separatorLen);
+
+		version_block->getVersionPtrAt(i)->format(out);
+
+		if (multistring)
+			out.put('\0');
+	}
+
+	return out.finish(); // the multistring's final \0 is the terminator
+}
+
+// version info
+///////////////
+
+SEMVER_API uint64_t semver_get_version_major(const HSemverVersion version)
+{
+	return reinterpret_cast<semver::Version*>(version)->major;
+}
+
+SEMVER_API uint64_t semver_get_version_minor(const HSemverVersion version)
+{
+	return reinterpret_cast<semver::Version*>(version)->minor;
+}
+
+SEMVER_API uint64_t semver_get_version_patch(const HSemverVersion version)
+{
+	return reinterpret_cast<semver::Version*>(version)->patch;
+}
 
 SEMVER_API const char* semver_get_version_prerelease(const HSemverVersion version) // no need to dispose char*, disposed by HSemverVersion in semver_version_dispose
 {
@@ -388,17 +1178,32 @@ SEMVER_API const char* semver_get_version_build(const HSemverVersion version) //
 	return reinterpret_cast<semver::Version*>(version)->getBuild();
 }
 
-SEMVER_API char* semver_get_version_string(const HSemverVersion version) // \0 terminated string, freed with semver_free_version_string
+SEMVER_API char* semver_get_version_string(const HSemverVersion version) // \0 terminated string, freed with semver_free_string
+{
+	const semver::Version* v = reinterpret_cast<semver::Version*>(version);
+
+	size_t len = v->formattedLength();
+	char* str = new char[len + 1]; // freed with delete[] like cloneStr
+
+	semver::FormatBuffer out{ str, len + 1 };
+	v->format(out);
+	out.finish();
+
+	return str;
+}
+
+SEMVER_API size_t semver_version_format(const HSemverVersion version, char* buf, size_t cap)
 {
-	std::string s = reinterpret_cast<semver::Version*>(version)->toString();
-	return semver::cloneStr(s.data(), s.size());
+	semver::FormatBuffer out{ buf, cap };
+	reinterpret_cast<semver::Version*>(version)->format(out);
+	return out.finish();
 }
 
 // version/query string destructor
 ////////////////////////////
 SEMVER_API void semver_free_string(char* str)
 {
-	free(str);
+	delete[] str; // strings are allocated by cloneStr
 }
 
 
@@ -413,6 +1218,7 @@ SEMVER_API size_t semver_query_get_range_count(const HSemverQuery query)
 SEMVER_API HSemverRange semver_query_get_range_at_index(const HSemverQuery query, size_t index)
 {
 	semver::Query* q = reinterpret_cast<semver::Query*>(query);
+	q->rangeSet.stableOnly = false; // the range may be edited through its handle to match prereleases
 	return reinterpret_cast<HSemverRange>(&q->rangeSet[index]);
 }
 
@@ -549,6 +1355,7 @@ SEMVER_API HSemverRange semver_query_add_range(HSemverQuery query)
 {
 	semver::Query* q = reinterpret_cast<semver::Query*>(query);
 	semver::Range& r = q->rangeSet.emplace_back(semver::Range());
+	q->rangeSet.stableOnly = false; // the range may be edited through its handle to match prereleases
 	return reinterpret_cast<HSemverRange>(&r);
 }
 
@@ -557,8 +1364,7 @@ SEMVER_API void semver_query_erase_range_at_index(HSemverQuery query, size_t ind
 {
 	semver::Query* q = reinterpret_cast<semver::Query*>(query);
 
-	q->rangeSet[index].lower.juncture.deleteHeapResources(); // some fools might add build meta data so I can't just delete prerelease info
-	q->rangeSet[index].upper.juncture.deleteHeapResources(); 
+	q->rangeSet[index].deleteHeapResources(); // some fools might add build meta data so I can't just delete prerelease info
 
 	q->rangeSet.erase(q->rangeSet.begin() + index);
 }
@@ -571,7 +1377,7 @@ SEMVER_API SemverParseResult semver_range_set_min_prerelease(HSemverRange range,
 		return static_cast<SemverParseResult>(prerelease_result);
 
 	semver::Range* r = reinterpret_cast<semver::Range*>(range);
-	r->minPreRelease = std::string(prerelease);
+	r->minPreRelease.assign(prerelease);
 
 	return SEMVER_PARSE_SUCCESS;
 }
@@ -688,163 +1494,117 @@ SEMVER_API BOOL semver_query_matches_version(const HSemverQuery query, const HSe
 }
 
 
-struct StartEndIndex
+// first index in [low, high) where pred no longer holds. PRE: pred holds for a prefix of the block
+template<typename Pred>
+static size_t partitionPoint(const SemverVersionBlock& b, size_t low, size_t high, Pred pred)
 {
-	size_t startIndex;
-	size_t endIndex;
-};
+	while (low < high)
+	{
+		size_t mid = low + (high - low) / 2;
 
+		if (pred(*b.getVersionPtrAt(mid)))
+			low = mid + 1;
+		else
+			high = mid;
+	}
 
+	return low;
+}
 
-// PRE: block is not empty
-StartEndIndex findASCSortedBlockStartIndex(const semver::Query& q,  const SemverVersionBlock& b)
+// where a version with major.minor of v would be searched: a single major.minor if the block is indexed
+static StartEndIndex searchWindow(const VersionBlockPrefixIndex* index, const SemverVersionBlock& b, const semver::Version& v)
 {
+	if (!index)
+		return { 0, b.count };
 
-	const semver::Version& minVersion = q.lowBound().juncture;
-	const semver::Version& maxVersion = q.highBound().juncture;
-
-	
+	return index->slice(v.major, v.minor);
+}
 
+// PRE: block is not empty
+StartEndIndex findASCSortedBlockStartIndex(const semver::Version& minVersion, const semver::Version& maxVersion, const SemverVersionBlock& b, const VersionBlockPrefixIndex* index)
+{
 	size_t startindex = 0;
-	int low;
-	int high;
-	int mid;
 
 	if (!minVersion.isMinimum())
 	{
-		low = 0;
-		high = b.count - 1;
-
-		while (low <= high)
-		{
-			mid = low + (high - low) / 2;
-			semver::Version& v = *b.getVersionPtrAt(mid);
-
-			if (v >= minVersion)
-			{
-				startindex = mid;
-				high = mid - 1;
-			}
-			if (v < minVersion)
-				low = mid + 1;
-
-		}
+		StartEndIndex w = searchWindow(index, b, minVersion); // all before are lower, all after are higher
+		startindex = partitionPoint(b, w.startIndex, w.endIndex, [&](const semver::Version& v) { return v < minVersion; });
 	}
 
-	size_t endindex = b.count-1;
+	size_t endindex = b.count;
 
 	if (!maxVersion.isMaximum())
 	{
-		low = startindex;
-		high = b.count - 1;
-
-		while (low <= high)
-		{
-			mid = low + (high - low) / 2;
-			semver::Version& v = *b.getVersionPtrAt(mid);
-
-			if (v <= maxVersion)
-			{
-				endindex = mid;
-				low = mid + 1;
-			}
-			if (v > maxVersion)
-				high = mid - 1;
-
-		}
+		StartEndIndex w = searchWindow(index, b, maxVersion);
+		size_t low = std::max(startindex, w.startIndex);
+		endindex = partitionPoint(b, low, std::max(low, w.endIndex), [&](const semver::Version& v) { return v <= maxVersion; });
 	}
 
-
 	return { startindex, endindex };
-
 }
 
 // PRE: block is not empty
-StartEndIndex findDESCSortedBlockStartIndex(const semver::Query& q, const SemverVersionBlock& b)
+StartEndIndex findDESCSortedBlockStartIndex(const semver::Version& minVersion, const semver::Version& maxVersion, const SemverVersionBlock& b, const VersionBlockPrefixIndex* index)
 {
-
-	const semver::Version& minVersion = q.lowBound().juncture;
-	const semver::Version& maxVersion = q.highBound().juncture;
-
-	int low;
-	int high;
-	int mid;
-
 	size_t startindex = 0;
+
 	if (!maxVersion.isMaximum())
 	{
-
-		low = 0;
-		high = b.count - 1;
-		while (low <= high)
-		{
-			mid = low + (high - low) / 2;
-			semver::Version& v = *b.getVersionPtrAt(mid);
-
-			if (v <= maxVersion)
-			{
-				startindex = mid;
-				high = mid - 1;
-			}
-			if (v > maxVersion)
-				low = mid + 1;
-
-		}
+		StartEndIndex w = searchWindow(index, b, maxVersion); // all before are higher, all after are lower
+		startindex = partitionPoint(b, w.startIndex, w.endIndex, [&](const semver::Version& v) { return v > maxVersion; });
 	}
 
-	size_t endindex = b.count-1;
+	size_t endindex = b.count;
 
 	if (!minVersion.isMinimum())
 	{
+		StartEndIndex w = searchWindow(index, b, minVersion);
+		size_t low = std::max(startindex, w.startIndex);
+		endindex = partitionPoint(b, low, std::max(low, w.endIndex), [&](const semver::Version& v) { return v >= minVersion; });
+	}
 
-		low = startindex;
-		high = b.count - 1;
-
-		while (low <= high)
-		{
-			mid = low + (high - low) / 2;
-			semver::Version& v = *b.getVersionPtrAt(mid);
+	return { startindex, endindex };
+}
 
-			if (v >= minVersion)
-			{
-				endindex = mid;
-				low = mid + 1;
-			}
-			if (v < minVersion)
-				high = mid - 1;
 
-		}
-	}
+SEMVER_API BOOL semver_versions_index(HSemverVersions version_array)
+{
+	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(version_array);
 
+	if (b->count == 0 || b->order == SEMVER_ORDER_AS_GIVEN)
+		return FALSE;
 
-	return { startindex, endindex };
-
+	delete b->index;
+	b->index = new VersionBlockPrefixIndex(*b);
+	return TRUE;
 }
 
-
 SEMVER_API HSemverVersions semver_query_match_versions(const HSemverQuery query, const HSemverVersions versions)
 {
+	semver::stats::count(semver::stats::BLOCK_QUERIES);
 	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(versions);
+	semver::trace::Span match(SEMVER_TRACE_MATCH, b->count);
 
 	if (b->count == 0)
 		return SemverVersionBlock::getEmptyBlockHandle();
 
 	semver::Query* q = reinterpret_cast<semver::Query*>(query);
 
-	StartEndIndex indices{ 0, b->count-1 };
+	StartEndIndex indices{ 0, b->count };
+	const VersionBlockPrefixIndex* index = b->index;
 
 	if (b->order == SEMVER_ORDER_ASC)
-		indices = findASCSortedBlockStartIndex(*q, *b);
+		indices = findASCSortedBlockStartIndex(q->lowBound().juncture, q->highBound().juncture, *b, index);
 	else if (b->order == SEMVER_ORDER_DESC)
-		indices = findDESCSortedBlockStartIndex(*q, *b);
+		indices = findDESCSortedBlockStartIndex(q->lowBound().juncture, q->highBound().juncture, *b, index);
 
-	if (indices.startIndex > indices.endIndex)
+	if (indices.startIndex >= indices.endIndex)
 		return SemverVersionBlock::getEmptyBlockHandle();
 
 
 	std::vector<semver::Version*> matched;
 
-	for (size_t i = indices.startIndex; i <= indices.endIndex; ++i)
+	for (size_t i = indices.startIndex; i < indices.endIndex; ++i)
 	{
 		semver::Version* v = b->getVersionPtrAt(i);
 
@@ -853,6 +1613,7 @@ SEMVER_API HSemverVersions semver_query_match_versions(const HSemverQuery query,
 	}
 
 	size_t matchCount = matched.size();
+	match.setResult(matchCount, 0);
 
 	if (matchCount == 0)
 		return reinterpret_cast<HSemverVersions>(SemverVersionBlock::getEmptyBlockHandle());
@@ -865,11 +1626,219 @@ SEMVER_API HSemverVersions semver_query_match_versions(const HSemverQuery query,
 
 }
 
+// the positions of a sorted block each range of the query can match, ascending and disjoint. PRE: block is not empty
+static std::vector<StartEndIndex> findSortedBlockRangeWindows(const semver::Query& q, SemverVersionBlock& b)
+{
+	const VersionBlockPrefixIndex* index = b.index;
+	std::vector<StartEndIndex> windows;
+
+	for (const semver::Range& r : q.rangeSet)
+	{
+		if (semver::Version::compare(r.lower.juncture, r.upper.juncture) > 0)
+			continue; // matches nothing
+
+		StartEndIndex w = (b.order == SEMVER_ORDER_ASC) ?
+			findASCSortedBlockStartIndex(r.lower.juncture, r.upper.juncture, b, index) :
+			findDESCSortedBlockStartIndex(r.lower.juncture, r.upper.juncture, b, index);
+
+		if (w.startIndex < w.endIndex)
+			windows.push_back(w);
+	}
+
+	std::sort(windows.begin(), windows.end(), [](const StartEndIndex& x, const StartEndIndex& y) { return x.startIndex < y.startIndex; });
+
+	size_t merged = 0; // ranges of a query may overlap
+
+	for (const StartEndIndex& w : windows)
+	{
+		if (merged > 0 && w.startIndex <= windows[merged - 1].endIndex)
+			windows[merged - 1].endIndex = std::max(windows[merged - 1].endIndex, w.endIndex);
+		else
+			windows[merged++] = w;
+	}
+
+	windows.resize(merged);
+	return windows;
+}
+
+SEMVER_API HSemverVersions semver_query_match_versions_limit(const HSemverQuery query, const HSemverVersions versions, size_t offset, size_t limit, SemverOrder order)
+{
+	semver::stats::count(semver::stats::BLOCK_QUERIES);
+	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(versions);
+	semver::trace::Span match(SEMVER_TRACE_MATCH, b->count);
+
+	if (b->count == 0 || limit == 0)
+		return SemverVersionBlock::getEmptyBlockHandle();
+
+	const semver::Query* q = reinterpret_cast<const semver::Query*>(query);
+
+	if (order == SEMVER_ORDER_AS_GIVEN)
+		order = b->order;
+
+	std::vector<semver::Version*> matched;
+
+	if (b->order == SEMVER_ORDER_AS_GIVEN && order != SEMVER_ORDER_AS_GIVEN) // unsorted: only the matches that are kept are sorted
+	{
+		for (size_t i = 0; i < b->count; ++i)
+		{
+			semver::Version* v = b->getVersionPtrAt(i);
+
+			if (q->matches(*v))
+				matched.push_back(v);
+		}
+
+		if (matched.size() <= offset)
+			matched.clear();
+		else
+		{
+			size_t kept = (matched.size() - offset > limit) ? offset + limit : matched.size();
+
+			std::partial_sort(matched.begin(), matched.begin() + kept, matched.end(), [order](const semver::Version* x, const semver::Version* y)
+				{ return (order == SEMVER_ORDER_ASC) ? *x < *y : *x > *y; });
+
+			matched.erase(matched.begin() + kept, matched.end());
+			matched.erase(matched.begin(), matched.begin() + offset);
+		}
+	}
+	else // walk the block in the requested order, until limit matches are found
+	{
+		size_t skipped = 0;
+
+		auto visit = [&](size_t i) // false once the limit is reached
+			{
+				semver::Version* v = b->getVersionPtrAt(i);
+
+				if (!q->matches(*v))
+					return true;
+
+				if (skipped < offset)
+					++skipped;
+				else
+					matched.push_back(v);
+
+				return matched.size() < limit;
+			};
+
+		if (b->order == SEMVER_ORDER_AS_GIVEN)
+		{
+			for (size_t i = 0; i < b->count && visit(i); ++i)
+				;
+		}
+		else
+		{
+			std::vector<StartEndIndex> windows = findSortedBlockRangeWindows(*q, *b);
+			bool forward = order == b->order;
+
+			auto visitWindow = [&](const StartEndIndex& w) // false once the limit is reached
+				{
+					if (forward)
+					{
+						for (size_t i = w.startIndex; i < w.endIndex; ++i)
+							if (!visit(i))
+								return false;
+					}
+					else
+					{
+						for (size_t i = w.endIndex; i-- > w.startIndex; )
+							if (!visit(i))
+								return false;
+					}
+
+					return true;
+				};
+
+			if (forward)
+				std::all_of(windows.begin(), windows.end(), visitWindow);
+			else
+				std::all_of(windows.rbegin(), windows.rend(), visitWindow);
+		}
+	}
+
+	match.setResult(matched.size(), 0);
+
+	if (matched.empty())
+		return SemverVersionBlock::getEmptyBlockHandle();
+
+	SemverVersionBlock* result = createVersionReferenceBlock(b->owner ? b->owner : b, matched.size()); // reference blocks don't own reference blocks
+	std::memcpy(result->versionPtrs, matched.data(), sizeof(semver::Version*) * matched.size());
+	result->order = order;
+
+	return reinterpret_cast<HSemverVersions>(result);
+}
+
+
+// the next positions of a sorted block a range of the query can match, from pos on: the lowest start and the furthest
+// end of the ranges that start there. Later overlapping ranges are picked up from the end. { count, count } if none is left
+static StartEndIndex findNextSortedBlockRangeWindow(const semver::Query& q, SemverVersionBlock& b, size_t pos)
+{
+	const VersionBlockPrefixIndex* index = b.index;
+	StartEndIndex next{ b.count, b.count };
+
+	for (const semver::Range& r : q.rangeSet)
+	{
+		if (semver::Version::compare(r.lower.juncture, r.upper.juncture) > 0)
+			continue; // matches nothing
+
+		StartEndIndex w = (b.order == SEMVER_ORDER_ASC) ?
+			findASCSortedBlockStartIndex(r.lower.juncture, r.upper.juncture, b, index) :
+			findDESCSortedBlockStartIndex(r.lower.juncture, r.upper.juncture, b, index);
+
+		if (w.endIndex <= pos || w.startIndex >= w.endIndex)
+			continue;
+
+		size_t start = std::max(w.startIndex, pos);
+
+		if (start < next.startIndex)
+			next = { start, w.endIndex };
+		else if (start == next.startIndex)
+			next.endIndex = std::max(next.endIndex, w.endIndex);
+	}
+
+	return next;
+}
+
+SEMVER_API void semver_match_cursor_init(HSemverMatchCursor cursor, const HSemverQuery query, const HSemverVersions versions)
+{
+	semver::stats::count(semver::stats::BLOCK_QUERIES);
+	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(versions);
+
+	cursor->query = query;
+	cursor->versions = versions;
+	cursor->next = 0;
+	cursor->end = (b->order == SEMVER_ORDER_AS_GIVEN) ? b->count : 0; // sorted blocks find their first window on the first next
+}
+
+SEMVER_API HSemverVersion semver_match_cursor_next(HSemverMatchCursor cursor)
+{
+	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(cursor->versions);
+	const semver::Query* q = reinterpret_cast<const semver::Query*>(cursor->query);
+
+	while (true)
+	{
+		while (cursor->next < cursor->end)
+		{
+			semver::Version* v = b->getVersionPtrAt(cursor->next++);
+
+			if (q->matches(*v))
+				return reinterpret_cast<HSemverVersion>(v);
+		}
+
+		if (cursor->next >= b->count || b->order == SEMVER_ORDER_AS_GIVEN)
+			return nullptr;
+
+		StartEndIndex w = findNextSortedBlockRangeWindow(*q, *b, cursor->next);
+		cursor->next = w.startIndex;
+		cursor->end = w.endIndex;
+	}
+}
+
 
 SEMVER_API HSemverVersion semver_query_highest_match(const HSemverQuery query, const HSemverVersions versions)
 {
+	semver::stats::count(semver::stats::BLOCK_QUERIES);
 	semver::Query* q = reinterpret_cast<semver::Query*>(query);
 	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(versions);
+	semver::trace::Span match(SEMVER_TRACE_MATCH, b->count);
 
 	// consider a solution that sorts versions in a reference block or if the source versions is sorted (may need a flag)
 	semver::Version* vMax = nullptr;
@@ -885,15 +1854,441 @@ SEMVER_API HSemverVersion semver_query_highest_match(const HSemverQuery query, c
 		}
 	}
 
+	match.setResult(vMax ? 1 : 0, 0);
 	return reinterpret_cast<HSemverVersion>(vMax);
 
 }
 
+// positions of a version block in ascending order. PRE: block is not empty
+struct AscendingBlockView
+{
+	const SemverVersionBlock& b;
+	std::vector<size_t> permutation; // only for unsorted blocks
+
+	explicit AscendingBlockView(const SemverVersionBlock& b)
+		: b(b)
+	{
+		if (b.order != SEMVER_ORDER_AS_GIVEN)
+			return;
+
+		permutation.resize(b.count);
+
+		for (size_t i = 0; i < b.count; ++i)
+			permutation[i] = i;
+
+		std::stable_sort(permutation.begin(), permutation.end(), [&b](size_t x, size_t y) { return *b.getVersionPtrAt(x) < *b.getVersionPtrAt(y); });
+	}
+
+	size_t blockIndex(size_t pos) const
+	{
+		switch (b.order)
+		{
+		case SEMVER_ORDER_ASC:
+			return pos;
+		case SEMVER_ORDER_DESC:
+			return b.count - 1 - pos;
+		default:
+			return permutation[pos];
+		}
+	}
+
+	const semver::Version& at(size_t pos) const { return *b.getVersionPtrAt(blockIndex(pos)); }
+};
+
+static void setBit(uint64_t* bits, size_t index) { bits[index / 64] |= 1ull << (index % 64); }
+
+// sets bits [start, end) that are also set in mask
+static void setMaskedBits(uint64_t* bits, const uint64_t* mask, size_t start, size_t end)
+{
+	while (start < end && start % 64 != 0)
+	{
+		bits[start / 64] |= mask[start / 64] & (1ull << (start % 64));
+		++start;
+	}
+
+	for (; start + 64 <= end; start += 64)
+		bits[start / 64] |= mask[start / 64];
+
+	if (start < end)
+		bits[start / 64] |= mask[start / 64] & ((1ull << (end - start)) - 1);
+}
+
+SEMVER_API void semver_queries_match_versions(const HSemverQuery* queries, size_t query_count, const HSemverVersions versions, uint64_t* match_bits)
+{
+	semver::stats::count(semver::stats::BLOCK_QUERIES, query_count);
+	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(versions);
+	size_t words = SEMVER_MATCH_BITS_WORDS(b->count);
+	semver::trace::Span match(SEMVER_TRACE_MATCH, b->count * query_count);
+
+	std::fill_n(match_bits, words * query_count, 0);
+
+	if (b->count == 0)
+		return;
+
+	AscendingBlockView sorted(*b);
+
+	std::vector<uint64_t> stableMask(words, 0); // by block index: defined versions without prerelease, which only need the bounds checked
+	std::vector<size_t> prereleasePositions; // ascending positions of versions with prerelease, which need Range::matches
+
+	for (size_t pos = 0; pos < b->count; ++pos)
+	{
+		const semver::Version& v = sorted.at(pos);
+
+		if (!v.isDefined())
+			continue;
+
+		if (v.isPrerelease())
+			prereleasePositions.push_back(pos);
+		else
+			setBit(stableMask.data(), sorted.blockIndex(pos));
+	}
+
+	struct RangeRef
+	{
+		const semver::Range* range;
+		size_t query;
+		size_t start = 0; // first position within the bounds
+		size_t end = 0; // one past the last position within the bounds
+	};
+
+	std::vector<RangeRef> ranges;
+
+	for (size_t q = 0; q < query_count; ++q)
+		for (const semver::Range& r : reinterpret_cast<const semver::Query*>(queries[q])->rangeSet)
+			ranges.push_back({ &r, q });
+
+	// both bounds admit a suffix (lower) or prefix (upper) of the ascending versions, so sorting the bounds lets a 
+	// single sweep over the versions find where every range starts and ends
+	std::vector<RangeRef*> byBound(ranges.size());
+
+	for (size_t i = 0; i < ranges.size(); ++i)
+		byBound[i] = &ranges[i];
+
+	std::sort(byBound.begin(), byBound.end(), [](const RangeRef* x, const RangeRef* y)
+		{
+			int comp = semver::Version::compare(x->range->lower.juncture, y->range->lower.juncture);
+			return comp < 0 || (comp == 0 && x->range->lower.isIncluded() && !y->range->lower.isIncluded());
+		});
+
+	size_t pos = 0;
+
+	for (RangeRef* ref : byBound)
+	{
+		while (pos < b->count && !ref->range->lowerAdmits(sorted.at(pos)))
+			++pos;
+
+		ref->start = pos;
+	}
+
+	std::sort(byBound.begin(), byBound.end(), [](const RangeRef* x, const RangeRef* y)
+		{
+			int comp = semver::Version::compare(x->range->upper.juncture, y->range->upper.juncture);
+			return comp < 0 || (comp == 0 && !x->range->upper.isIncluded() && y->range->upper.isIncluded());
+		});
+
+	pos = 0;
+
+	for (RangeRef* ref : byBound)
+	{
+		while (pos < b->count && ref->range->upperAdmits(sorted.at(pos)))
+			++pos;
+
+		ref->end = pos;
+	}
+
+	for (const RangeRef& ref : ranges)
+	{
+		if (ref.start >= ref.end)
+			continue;
+
+		uint64_t* bits = match_bits + ref.query * words;
+
+		switch (b->order) // stable versions within the bounds match
+		{
+		case SEMVER_ORDER_ASC:
+			setMaskedBits(bits, stableMask.data(), ref.start, ref.end);
+			break;
+		case SEMVER_ORDER_DESC: // still contiguous, just mirrored
+			setMaskedBits(bits, stableMask.data(), b->count - ref.end, b->count - ref.start);
+			break;
+		default:
+			for (size_t p = ref.start; p < ref.end; ++p)
+				if (!sorted.at(p).isPrerelease() && sorted.at(p).isDefined())
+					setBit(bits, sorted.permutation[p]);
+		}
+
+		auto it = std::lower_bound(prereleasePositions.begin(), prereleasePositions.end(), ref.start);
+
+		for (; it != prereleasePositions.end() && *it < ref.end; ++it)
+			if (ref.range->matches(sorted.at(*it)))
+				setBit(bits, sorted.blockIndex(*it));
+	}
+
+	if (match.active())
+		match.setResult(std::accumulate(match_bits, match_bits + words * query_count, uint64_t(0),
+			[](uint64_t sum, uint64_t word) { return sum + std::popcount(word); }), 0);
+}
+
+// query algebra
+////////////////
+
+static HSemverQuery newQuery(const semver::Query& from, semver::RangeSet&& ranges)
+{
+	semver::Query* q = new semver::Query();
+	q->productName = from.productName;
+	q->rangeSet = std::move(ranges);
+	q->rangeSet.chooseMatcher();
+	return reinterpret_cast<HSemverQuery>(q);
+}
+
+SEMVER_API HSemverQuery semver_query_intersect(const HSemverQuery lhs, const HSemverQuery rhs)
+{
+	const semver::Query* l = reinterpret_cast<const semver::Query*>(lhs);
+	const semver::Query* r = reinterpret_cast<const semver::Query*>(rhs);
+	return newQuery(*l, semver::intersect(l->rangeSet, r->rangeSet));
+}
+
+SEMVER_API HSemverQuery semver_query_union(const HSemverQuery lhs, const HSemverQuery rhs)
+{
+	const semver::Query* l = reinterpret_cast<const semver::Query*>(lhs);
+	const semver::Query* r = reinterpret_cast<const semver::Query*>(rhs);
+	return newQuery(*l, semver::unite(l->rangeSet, r->rangeSet));
+}
+
+SEMVER_API HSemverQuery semver_query_complement(const HSemverQuery query)
+{
+	const semver::Query* q = reinterpret_cast<const semver::Query*>(query);
+	return newQuery(*q, semver::complement(q->rangeSet));
+}
+
+SEMVER_API BOOL semver_query_is_subset(const HSemverQuery lhs, const HSemverQuery rhs)
+{
+	return semver::isSubsetOf(reinterpret_cast<const semver::Query*>(lhs)->rangeSet, reinterpret_cast<const semver::Query*>(rhs)->rangeSet);
+}
+
+SEMVER_API BOOL semver_query_is_disjoint(const HSemverQuery lhs, const HSemverQuery rhs)
+{
+	return semver::isDisjoint(reinterpret_cast<const semver::Query*>(lhs)->rangeSet, reinterpret_cast<const semver::Query*>(rhs)->rangeSet);
+}
+
+// query index
+//////////////
+
+struct SemverQueryIndex
+{
+	semver::QueryIndex index;
+	std::vector<uint64_t> matched; // reused between matches
+};
+
+SEMVER_API HSemverQueryIndex semver_query_index_create()
+{
+	return reinterpret_cast<HSemverQueryIndex>(new SemverQueryIndex());
+}
+
+SEMVER_API void semver_query_index_add(HSemverQueryIndex index, const HSemverQuery query, uint64_t id)
+{
+	reinterpret_cast<SemverQueryIndex*>(index)->index.add(*reinterpret_cast<const semver::Query*>(query), id);
+}
+
+SEMVER_API BOOL semver_query_index_remove(HSemverQueryIndex index, uint64_t id)
+{
+	return reinterpret_cast<SemverQueryIndex*>(index)->index.remove(id) != 0;
+}
+
+SEMVER_API size_t semver_query_index_match(HSemverQueryIndex index, const HSemverVersion version, uint64_t* ids, size_t cap)
+{
+	SemverQueryIndex* qi = reinterpret_cast<SemverQueryIndex*>(index);
+	qi->index.match(*reinterpret_cast<const semver::Version*>(version), qi->matched);
+
+	std::copy_n(qi->matched.begin(), std::min(cap, qi->matched.size()), ids);
+
+	return qi->matched.size();
+}
+
+SEMVER_API void semver_query_index_dispose(HSemverQueryIndex index)
+{
+	delete reinterpret_cast<SemverQueryIndex*>(index);
+}
+
+// query watch
+//////////////
+
+struct SemverQueryWatch
+{
+	semver::QueryWatch watch;
+	std::vector<uint64_t> changed; // reused between pushes
+};
+
+SEMVER_API HSemverQueryWatch semver_query_watch_create()
+{
+	return reinterpret_cast<HSemverQueryWatch>(new SemverQueryWatch());
+}
+
+SEMVER_API void semver_query_watch_add(HSemverQueryWatch watch, const HSemverQuery query, uint64_t id)
+{
+	reinterpret_cast<SemverQueryWatch*>(watch)->watch.add(*reinterpret_cast<const semver::Query*>(query), id);
+}
+
+SEMVER_API BOOL semver_query_watch_remove(HSemverQueryWatch watch, uint64_t id)
+{
+	return reinterpret_cast<SemverQueryWatch*>(watch)->watch.remove(id) != 0;
+}
+
+SEMVER_API size_t semver_query_watch_push(HSemverQueryWatch watch, const HSemverVersion version, uint64_t* ids, size_t cap)
+{
+	SemverQueryWatch* qw = reinterpret_cast<SemverQueryWatch*>(watch);
+	qw->watch.push(*reinterpret_cast<const semver::Version*>(version), qw->changed);
+
+	std::copy_n(qw->changed.begin(), std::min(cap, qw->changed.size()), ids);
+
+	return qw->changed.size();
+}
+
+SEMVER_API HSemverVersion semver_query_watch_best(const HSemverQueryWatch watch, uint64_t id)
+{
+	const semver::Version* best = reinterpret_cast<const SemverQueryWatch*>(watch)->watch.best(id);
+	return reinterpret_cast<HSemverVersion>(const_cast<semver::Version*>(best));
+}
+
+SEMVER_API void semver_query_watch_dispose(HSemverQueryWatch watch)
+{
+	delete reinterpret_cast<SemverQueryWatch*>(watch);
+}
+
+// resolver
+///////////
+
+SEMVER_API HSemverResolver semver_resolver_create()
+{
+	return reinterpret_cast<HSemverResolver>(new semver::Resolver());
+}
+
+SEMVER_API BOOL semver_resolver_add_package(HSemverResolver resolver, const char* product, const HSemverVersions versions)
+{
+	SemverVersionBlock* b = SemverVersionBlock::pointerFromHandle(versions);
+	std::vector<const semver::Version*> ptrs(b->count);
+
+	for (size_t i = 0; i < b->count; ++i)
+		ptrs[i] = b->getVersionPtrAt(i);
+
+	return reinterpret_cast<semver::Resolver*>(resolver)->addPackage(product ? product : "", ptrs.data(), ptrs.size());
+}
+
+SEMVER_API BOOL semver_resolver_add_dependency(HSemverResolver resolver, const char* product, size_t version_index, const char* dependency, const HSemverQuery query)
+{
+	if (!query)
+		return FALSE;
+
+	return reinterpret_cast<semver::Resolver*>(resolver)->addDependency(product ? product : "", version_index, dependency ? dependency : "",
+		reinterpret_cast<const semver::Query*>(query)->rangeSet);
+}
+
+SEMVER_API void semver_resolver_require(HSemverResolver resolver, const char* product, const HSemverQuery query)
+{
+	if (!query)
+		return;
+
+	reinterpret_cast<semver::Resolver*>(resolver)->require(product ? product : "", reinterpret_cast<const semver::Query*>(query)->rangeSet);
+}
+
+SEMVER_API BOOL semver_resolver_solve(HSemverResolver resolver)
+{
+	return reinterpret_cast<semver::Resolver*>(resolver)->solve();
+}
+
+SEMVER_API size_t semver_resolver_selected_count(const HSemverResolver resolver)
+{
+	return reinterpret_cast<const semver::Resolver*>(resolver)->solution().size();
+}
+
+SEMVER_API const char* semver_resolver_selected_product_at_index(const HSemverResolver resolver, size_t index)
+{
+	return reinterpret_cast<const semver::Resolver*>(resolver)->solution()[index].name->c_str();
+}
+
+SEMVER_API HSemverVersion semver_resolver_selected_version_at_index(const HSemverResolver resolver, size_t index)
+{
+	const semver::Version* v = reinterpret_cast<const semver::Resolver*>(resolver)->solution()[index].version;
+	return reinterpret_cast<HSemverVersion>(const_cast<semver::Version*>(v));
+}
+
+SEMVER_API HSemverVersion semver_resolver_get_selected(const HSemverResolver resolver, const char* product)
+{
+	const semver::Version* v = reinterpret_cast<const semver::Resolver*>(resolver)->selectedVersion(product ? product : "");
+	return reinterpret_cast<HSemverVersion>(const_cast<semver::Version*>(v));
+}
+
+SEMVER_API size_t semver_resolver_format_conflict(const HSemverResolver resolver, char* buf, size_t cap)
+{
+	std::string explanation = reinterpret_cast<const semver::Resolver*>(resolver)->explainConflict();
+	semver::FormatBuffer out{ buf, cap };
+	out.put(explanation.data(), explanation.size());
+	return out.finish();
+}
+
+SEMVER_API void semver_resolver_dispose(HSemverResolver resolver)
+{
+	delete reinterpret_cast<semver::Resolver*>(resolver);
+}
+
 // Query check methods
 ///////////////////////
-SEMVER_API const char* semver_get_query_string(const HSemverQuery query) // \0 terminated string. Caller needs to free
+SEMVER_API const char* semver_get_query_string(const HSemverQuery query) // \0 terminated string. Caller needs to free with semver_free_string
 {
 	semver::Query* q = reinterpret_cast<semver::Query*>(query);
 	std::string s = q->toString();
 	return semver::cloneStr(s.c_str(), s.size());
 }
+
+SEMVER_API size_t semver_query_format(const HSemverQuery query, char* buf, size_t cap)
+{
+	semver::FormatBuffer out{ buf, cap };
+	reinterpret_cast<semver::Query*>(query)->format(out);
+	return out.finish();
+}
+
+
+// statistics
+/////////////
+
+static_assert(sizeof(SemverStats) == sizeof(uint64_t) * semver::stats::COUNTER_COUNT, "a SemverStats field per counter");
+
+SEMVER_API BOOL semver_stats_snapshot(SemverStats* stats)
+{
+	uint64_t values[semver::stats::COUNTER_COUNT] = {};
+
+#ifdef SEMVER_ENABLE_STATS
+	semver::stats::totals(values);
+#endif
+
+	memcpy(stats, values, sizeof(values));
+
+#ifdef SEMVER_ENABLE_STATS
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+SEMVER_API void semver_stats_reset()
+{
+	semver::stats::reset();
+}
+
+// tracing
+//////////
+
+SEMVER_API void semver_trace_set_callback(SemverTraceCallback callback, void* context)
+{
+	semver::trace::setCallback(callback, context);
+}
+
+SEMVER_API BOOL semver_trace_chrome_begin(const char* path)
+{
+	return semver::trace::beginChromeTrace(path) ? TRUE : FALSE;
+}
+
+SEMVER_API void semver_trace_chrome_end()
+{
+	semver::trace::endChromeTrace();
+}
@@ -0,0 +1,187 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SEMVER_SIMD_SSSE3
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace semver
+{
+	namespace simd
+	{
+		// prerelease and build segments shorter than this are checked one identifier at a time
+		constexpr size_t minIdentifiersLength = 16;
+
+		// SWAR (SIMD within a register) digit conversion, eight characters in a uint64_t with the first one in the
+		// lowest byte
+		constexpr uint64_t loadEight(const char* chars)
+		{
+			uint64_t value = 0;
+
+			if (!std::is_constant_evaluated() && std::endian::native == std::endian::little)
+				std::memcpy(&value, chars, 8);
+			else
+				for (size_t i = 0; i < 8; ++i)
+					value |= static_cast<uint64_t>(static_cast<uint8_t>(chars[i])) << (8 * i);
+
+			return value;
+		}
+
+		constexpr bool isEightDigits(uint64_t chars) // a byte below '0' borrows, one above '9' carries into the high bit
+		{
+			return (((chars + 0x4646464646464646) | (chars - 0x3030303030303030)) & 0x8080808080808080) == 0;
+		}
+
+		constexpr uint64_t parseEightDigits(uint64_t chars) // digits only
+		{
+			chars -= 0x3030303030303030;
+			chars = (chars * 10) + (chars >> 8); // pairs of digits in every other byte
+			chars = (((chars & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+				(((chars >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+			return chars;
+		}
+
+#ifdef SEMVER_SIMD_SSSE3
+#if defined(__GNUC__) && !defined(__SSSE3__)
+#define SEMVER_TARGET_SSSE3 __attribute__((target("ssse3"))) // the rest of the library keeps the baseline
+#else
+#define SEMVER_TARGET_SSSE3
+#endif
+
+		inline bool hasSsse3()
+		{
+#if defined(__SSSE3__)
+			return true;
+#elif defined(_MSC_VER)
+			static const bool supported = []
+				{
+					int info[4];
+					__cpuid(info, 1);
+					return (info[2] & (1 << 9)) != 0;
+				}();
+			return supported;
+#else
+			static const bool supported = __builtin_cpu_supports("ssse3");
+			return supported;
+#endif
+		}
+
+		// a character is in the classes that both its low and its high nibble allow, none for invalid characters
+		enum CharClass : uint8_t
+		{
+			DIGIT = 1,
+			HYPHEN = 2,
+			DOT = 4,
+			LETTER_A_O = 8, // A-O and a-o, low nibbles 1-F
+			LETTER_P_Z = 16, // P-Z and p-z, low nibbles 0-A
+		};
+
+		struct ChunkMasks // bit i for character i
+		{
+			uint32_t invalid;
+			uint32_t dots;
+			uint32_t digits;
+			uint32_t zeros;
+		};
+
+		SEMVER_TARGET_SSSE3 inline ChunkMasks classify(const char* chunk) // 16 characters
+		{
+			const __m128i lowNibbleClasses = _mm_setr_epi8(
+				DIGIT | LETTER_P_Z,
+				DIGIT | LETTER_A_O | LETTER_P_Z, DIGIT | LETTER_A_O | LETTER_P_Z, DIGIT | LETTER_A_O | LETTER_P_Z,
+				DIGIT | LETTER_A_O | LETTER_P_Z, DIGIT | LETTER_A_O | LETTER_P_Z, DIGIT | LETTER_A_O | LETTER_P_Z,
+				DIGIT | LETTER_A_O | LETTER_P_Z, DIGIT | LETTER_A_O | LETTER_P_Z, DIGIT | LETTER_A_O | LETTER_P_Z,
+				LETTER_A_O | LETTER_P_Z,
+				LETTER_A_O, LETTER_A_O, HYPHEN | LETTER_A_O, DOT | LETTER_A_O, LETTER_A_O);
+
+			const __m128i highNibbleClasses = _mm_setr_epi8(
+				0, 0, HYPHEN | DOT, DIGIT, LETTER_A_O, LETTER_P_Z, LETTER_A_O, LETTER_P_Z,
+				0, 0, 0, 0, 0, 0, 0, 0);
+
+			const __m128i nibble = _mm_set1_epi8(0x0F);
+
+			__m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk));
+			__m128i low = _mm_and_si128(characters, nibble);
+			__m128i high = _mm_and_si128(_mm_srli_epi16(characters, 4), nibble);
+			__m128i classes = _mm_and_si128(_mm_shuffle_epi8(lowNibbleClasses, low), _mm_shuffle_epi8(highNibbleClasses, high));
+
+			ChunkMasks masks;
+			masks.invalid = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(classes, _mm_setzero_si128())));
+			masks.dots = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(classes, _mm_set1_epi8(DOT))));
+			masks.digits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(classes, _mm_set1_epi8(DIGIT))));
+			masks.zeros = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(characters, _mm_set1_epi8('0'))));
+			return masks;
+		}
+
+		SEMVER_TARGET_SSSE3 inline bool validIdentifiersSsse3(const char* buffer, size_t len, bool rejectLeadingZeros)
+		{
+			if (buffer[len - 1] == '.')
+				return false;
+
+			uint32_t afterDot = 1; // the first identifier starts like one after a dot, so a leading dot is an empty identifier
+			uint32_t zeroStart = 0; // the chunk before ended in an identifier that starts with 0
+
+			for (size_t offset = 0; offset < len; offset += 16)
+			{
+				size_t count = len - offset;
+				ChunkMasks masks;
+				uint32_t inSegment = 0xFFFF;
+
+				if (count >= 16)
+					masks = classify(buffer + offset);
+				else
+				{
+					char tail[16] = {};
+					std::memcpy(tail, buffer + offset, count);
+					masks = classify(tail);
+					inSegment = (1u << count) - 1;
+				}
+
+				if (masks.invalid & inSegment)
+					return false;
+
+				uint32_t starts = ((masks.dots << 1) | afterDot) & inSegment;
+
+				if (masks.dots & starts) // two dots in a row
+					return false;
+
+				if (rejectLeadingZeros)
+				{
+					uint32_t zeroStarts = starts & masks.zeros;
+
+					if ((((zeroStarts << 1) | zeroStart) & masks.digits & inSegment) != 0) // 0 followed by a digit
+						return false;
+
+					zeroStart = zeroStarts >> 15;
+				}
+
+				afterDot = masks.dots >> 15;
+			}
+
+			return true;
+		}
+#endif
+
+		// true when every identifier is non-empty and only has [0-9A-Za-z-] characters, and with rejectLeadingZeros
+		// no identifier starts with a 0 followed by a digit. false leaves it to the identifier by identifier checks,
+		// which find the error, or accept an identifier like 01a. len is at least 1
+		inline bool validIdentifiers(const char* buffer, size_t len, bool rejectLeadingZeros)
+		{
+#ifdef SEMVER_SIMD_SSSE3
+			if (hasSsse3())
+				return validIdentifiersSsse3(buffer, len, rejectLeadingZeros);
+#endif
+			return false;
+		}
+	}
+}
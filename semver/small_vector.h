@@ -0,0 +1,164 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace semver
+{
+	// A vector that keeps its first N items inline and only allocates when it grows past them. Items are
+	// trivially copyable: they are copied around as values, so whatever they point to is shared, not cloned.
+	// constexpr, so it can be used while parsing at compile time
+	template <class T, size_t N>
+	class SmallVector
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "items are moved by copying");
+
+	public:
+
+		typedef T value_type;
+		typedef T* iterator;
+		typedef const T* const_iterator;
+
+		constexpr SmallVector() = default;
+
+		constexpr SmallVector(const SmallVector& other) { append(other); }
+
+		constexpr SmallVector(SmallVector&& other) noexcept { take(other); }
+
+		constexpr SmallVector& operator=(const SmallVector& other)
+		{
+			if (this != &other)
+			{
+				count = 0;
+				append(other);
+			}
+
+			return *this;
+		}
+
+		constexpr SmallVector& operator=(SmallVector&& other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+				take(other);
+			}
+
+			return *this;
+		}
+
+		constexpr ~SmallVector() { release(); }
+
+		constexpr size_t size() const { return count; }
+		constexpr bool empty() const { return count == 0; }
+		constexpr size_t capacity() const { return allocated; }
+		constexpr bool isInline() const { return items == inline_items; }
+
+		constexpr T* data() { return items; }
+		constexpr const T* data() const { return items; }
+
+		constexpr iterator begin() { return items; }
+		constexpr iterator end() { return items + count; }
+		constexpr const_iterator begin() const { return items; }
+		constexpr const_iterator end() const { return items + count; }
+
+		constexpr T& operator[](size_t index) { return items[index]; }
+		constexpr const T& operator[](size_t index) const { return items[index]; }
+
+		constexpr T& front() { return items[0]; }
+		constexpr const T& front() const { return items[0]; }
+		constexpr T& back() { return items[count - 1]; }
+		constexpr const T& back() const { return items[count - 1]; }
+
+		constexpr void reserve(size_t minimum)
+		{
+			if (minimum <= allocated)
+				return;
+
+			T* grown = new T[minimum];
+			std::copy_n(items, count, grown);
+
+			if (!isInline())
+				delete[] items;
+
+			items = grown;
+			allocated = minimum;
+		}
+
+		constexpr void push_back(const T& item)
+		{
+			if (count == allocated)
+			{
+				T copy = item; // item may be one of ours
+				reserve(allocated * 2);
+				items[count++] = copy;
+			}
+			else
+				items[count++] = item;
+		}
+
+		template <class... Args>
+		constexpr T& emplace_back(Args&&... args)
+		{
+			push_back(T(std::forward<Args>(args)...));
+			return back();
+		}
+
+		constexpr iterator erase(const_iterator position)
+		{
+			iterator at = items + (position - items);
+			std::copy(at + 1, end(), at);
+			--count;
+			return at;
+		}
+
+		constexpr void clear() { count = 0; } // keeps the capacity
+
+	private:
+
+		T inline_items[N];
+		T* items = inline_items;
+		size_t count = 0;
+		size_t allocated = N;
+
+		constexpr void append(const SmallVector& other)
+		{
+			reserve(other.count);
+			std::copy_n(other.items, other.count, items);
+			count = other.count;
+		}
+
+		constexpr void take(SmallVector& other)
+		{
+			if (other.isInline())
+			{
+				items = inline_items;
+				allocated = N;
+				std::copy_n(other.items, other.count, items);
+			}
+			else
+			{
+				items = other.items;
+				allocated = other.allocated;
+				other.items = other.inline_items;
+				other.allocated = N;
+			}
+
+			count = other.count;
+			other.count = 0;
+		}
+
+		constexpr void release()
+		{
+			if (!isInline())
+				delete[] items;
+
+			items = inline_items;
+			allocated = N;
+		}
+	};
+
+}
@@ -0,0 +1,70 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "stats.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace semver
+{
+	namespace stats
+	{
+		static std::mutex sMutex;
+		static std::vector<ThreadCounters*> sThreads; // registered and not exited
+		static uint64_t sExited[COUNTER_COUNT]; // counts of exited threads
+		static uint64_t sBaseline[COUNTER_COUNT]; // totals at the last reset
+
+		// a thread may count into more than one copy of the counters (one per module that inlined the counting)
+		struct ThreadExit
+		{
+			std::vector<ThreadCounters*> counters;
+
+			~ThreadExit()
+			{
+				std::lock_guard<std::mutex> lock(sMutex);
+
+				for (ThreadCounters* c : counters)
+				{
+					for (size_t i = 0; i < COUNTER_COUNT; ++i)
+						sExited[i] += c->values[i].load(std::memory_order_relaxed);
+
+					sThreads.erase(std::find(sThreads.begin(), sThreads.end(), c));
+				}
+			}
+		};
+
+		static thread_local ThreadExit tExit;
+
+		void registerThread(ThreadCounters& counters)
+		{
+			std::lock_guard<std::mutex> lock(sMutex);
+			sThreads.push_back(&counters);
+			tExit.counters.push_back(&counters);
+			counters.registered = true;
+		}
+
+		static void sum(uint64_t* values) // since the start, sMutex held
+		{
+			std::copy_n(sExited, COUNTER_COUNT, values);
+
+			for (const ThreadCounters* c : sThreads)
+				for (size_t i = 0; i < COUNTER_COUNT; ++i)
+					values[i] += c->values[i].load(std::memory_order_relaxed);
+		}
+
+		void totals(uint64_t* values)
+		{
+			std::lock_guard<std::mutex> lock(sMutex);
+			sum(values);
+
+			for (size_t i = 0; i < COUNTER_COUNT; ++i)
+				values[i] -= sBaseline[i];
+		}
+
+		void reset() // threads keep counting, so the totals are remembered rather than the counters cleared
+		{
+			std::lock_guard<std::mutex> lock(sMutex);
+			sum(sBaseline);
+		}
+	}
+}
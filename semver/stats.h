@@ -0,0 +1,66 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace semver
+{
+	namespace stats
+	{
+		// in the order of the fields of SemverStats
+		enum Counter : uint8_t
+		{
+			VERSION_PARSES,
+			PRERELEASE_HEAP_SPILLS,
+			BUILD_MAP_INSERTS,
+			VERSION_COMPARES,
+			PRERELEASE_COMPARES,
+			QUERY_MATCHES,
+			BLOCKS_CREATED,
+			BLOCK_SORTS,
+			BLOCK_QUERIES,
+
+			COUNTER_COUNT, // keep last
+		};
+
+		// Counters are collected per thread when the library is built with SEMVER_ENABLE_STATS, so counting is a
+		// relaxed store into memory no other thread writes. Snapshots sum the threads, exited threads included
+		struct ThreadCounters
+		{
+			std::atomic<uint64_t> values[COUNTER_COUNT];
+			bool registered = false;
+		};
+
+		void registerThread(ThreadCounters& counters);
+		void totals(uint64_t* values); // COUNTER_COUNT values, since the last reset
+		void reset();
+
+#ifdef SEMVER_ENABLE_STATS
+#if defined(__GNUC__) && !defined(_WIN32)
+		// a fixed offset from the thread pointer instead of a lookup per access, the library is not loaded late
+		inline thread_local ThreadCounters tCounters __attribute__((tls_model("initial-exec")));
+#else
+		inline thread_local ThreadCounters tCounters;
+#endif
+
+		inline void add(Counter counter, uint64_t n)
+		{
+			if (!tCounters.registered)
+				registerThread(tCounters);
+
+			std::atomic<uint64_t>& value = tCounters.values[counter];
+			value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+#endif
+
+		constexpr void count([[maybe_unused]] Counter counter, [[maybe_unused]] uint64_t n = 1)
+		{
+#ifdef SEMVER_ENABLE_STATS
+			if (!std::is_constant_evaluated())
+				add(counter, n);
+#endif
+		}
+	}
+}
@@ -0,0 +1,97 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "trace.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace semver
+{
+	namespace trace
+	{
+		std::atomic<SemverTraceCallback> sCallback{ nullptr };
+		void* sContext = nullptr;
+
+		// Chrome trace events, one JSON object per begin or end in an array (the trace event format)
+		struct ChromeTrace
+		{
+			std::mutex mutex; // events come from any thread
+			FILE* file = nullptr;
+			bool first = true;
+			std::chrono::steady_clock::time_point start;
+			std::unordered_map<std::thread::id, uint32_t> threads; // small ids read better than hashes
+
+			void write(const SemverTraceEvent& event)
+			{
+				static const char* names[] = { "split", "parse", "sort", "match" };
+
+				double ts = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+				std::lock_guard<std::mutex> lock(mutex);
+
+				if (!file)
+					return;
+
+				uint32_t tid = threads.try_emplace(std::this_thread::get_id(), static_cast<uint32_t>(threads.size() + 1)).first->second;
+
+				fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"semver\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"items\":%llu,\"bytes\":%llu}}",
+					first ? "" : ",", names[event.phase], event.begin ? "B" : "E", ts, tid,
+					static_cast<unsigned long long>(event.items), static_cast<unsigned long long>(event.bytes));
+
+				first = false;
+			}
+		};
+
+		static ChromeTrace sChromeTrace;
+
+		static void writeChromeEvent(void* context, const SemverTraceEvent* event)
+		{
+			static_cast<ChromeTrace*>(context)->write(*event);
+		}
+
+		void setCallback(SemverTraceCallback callback, void* context)
+		{
+			sContext = context;
+			sCallback.store(callback, std::memory_order_release);
+		}
+
+		bool beginChromeTrace(const char* path)
+		{
+			endChromeTrace(); // one trace file at a time
+
+			FILE* file = path ? fopen(path, "w") : nullptr;
+
+			if (!file)
+				return false;
+
+			{
+				std::lock_guard<std::mutex> lock(sChromeTrace.mutex);
+				sChromeTrace.file = file;
+				sChromeTrace.first = true;
+				sChromeTrace.start = std::chrono::steady_clock::now();
+				sChromeTrace.threads.clear();
+				fputs("[", file);
+			}
+
+			setCallback(writeChromeEvent, &sChromeTrace);
+			return true;
+		}
+
+		void endChromeTrace()
+		{
+			if (sCallback.load(std::memory_order_acquire) == writeChromeEvent)
+				setCallback(nullptr, nullptr);
+
+			std::lock_guard<std::mutex> lock(sChromeTrace.mutex);
+
+			if (sChromeTrace.file)
+			{
+				fputs("\n]\n", sChromeTrace.file);
+				fclose(sChromeTrace.file);
+				sChromeTrace.file = nullptr;
+			}
+		}
+	}
+}
@@ -0,0 +1,61 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include "API/semver.h"
+#include <atomic>
+
+namespace semver
+{
+	namespace trace
+	{
+		extern std::atomic<SemverTraceCallback> sCallback; // see semver_trace_set_callback
+		extern void* sContext;
+
+		void setCallback(SemverTraceCallback callback, void* context);
+		bool beginChromeTrace(const char* path); // writes Chrome trace events to path until endChromeTrace
+		void endChromeTrace();
+
+		// a phase from construction to destruction, reported to the callback set when it began. Without a callback
+		// it costs a load, so counts that take work to compute should be guarded with active()
+		class Span
+		{
+		public:
+
+			Span(SemverTracePhase phase, uint64_t items = 0, uint64_t bytes = 0)
+				: callback{ sCallback.load(std::memory_order_acquire) }, context{ sContext }, event{ phase, TRUE, items, bytes }
+			{
+				if (callback)
+				{
+					callback(context, &event);
+					event.items = event.bytes = 0; // the end reports the results, see setResult
+				}
+			}
+
+			~Span()
+			{
+				if (callback)
+				{
+					event.begin = FALSE;
+					callback(context, &event);
+				}
+			}
+
+			Span(const Span&) = delete;
+			Span& operator=(const Span&) = delete;
+
+			bool active() const { return callback != nullptr; }
+
+			void setResult(uint64_t items, uint64_t bytes) // reported with the end
+			{
+				event.items = items;
+				event.bytes = bytes;
+			}
+
+		private:
+
+			SemverTraceCallback callback;
+			void* context;
+			SemverTraceEvent event;
+		};
+	}
+}
@@ -2,14 +2,60 @@
 
 #pragma once
 #include "API/semver.h"
+#include "simd.h"
+#include "stats.h"
 #include <string>
 #include <cstring> //why is this not imported via semver.h?
+#include <charconv>
+#include <algorithm>
 
 namespace semver
 {
-	char* cloneStr(const char* src, size_t len);
+	char* cloneStr(const char* src, size_t len); // free with delete[]
 
-	inline size_t strlenSafe(const char* src) // we could add some extra safety checks for ridiculously long strings also later
+	// Writes into caller memory with snprintf semantics: the full length is always counted,
+	// but only cap - 1 characters are stored so there is room for the terminating \0
+	struct FormatBuffer
+	{
+		char* buf;
+		size_t cap;
+		size_t len = 0;
+
+		inline void put(char c)
+		{
+			if (len + 1 < cap)
+				buf[len] = c;
+
+			++len;
+		}
+
+		inline void put(const char* str, size_t n)
+		{
+			if (len + 1 < cap)
+				memcpy(buf + len, str, (len + n < cap) ? n : cap - 1 - len);
+
+			len += n;
+		}
+
+		inline void put(const char* str) { put(str, strlen(str)); }
+
+		inline void putNumber(uint64_t value)
+		{
+			char digits[20]; // 2^64 - 1 has 20 digits
+			auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+			put(digits, end - digits);
+		}
+
+		inline size_t finish() // terminates the string, returns the length it needed (excluding \0)
+		{
+			if (cap > 0)
+				buf[len < cap ? len : cap - 1] = '\0';
+
+			return len;
+		}
+	};
+
+	constexpr size_t strlenSafe(const char* src) // we could add some extra safety checks for ridiculously long strings also later
 	{
 		if (!src)
 			return 0;
@@ -23,6 +69,192 @@ namespace semver
 		
 	}
 
+	// parsing helpers, constexpr (like the Version parser and the range builders) so literals can be parsed at compile time
+
+	constexpr bool strEmpty(const char* str)
+	{
+		return !(str && *str);
+	}
+
+
+	constexpr size_t getCharPosEx(char c, const char* buffer, size_t len, size_t start)
+	{
+		for (size_t i = start; i < len; ++i)
+			if (buffer[i] == c)
+				return i;
+
+		return len; // consider vs -1
+	}
+
+	constexpr size_t getDotPos(const char* buffer, size_t len)
+	{
+		for (size_t i = 0; i < len; ++i)
+			if (buffer[i] == '.')
+				return i;
+
+		return len; // consider vs -1
+	}
+
+	constexpr size_t getDotPosEx(const char* buffer, size_t len, size_t start)
+	{
+		for (size_t i = start; i < len; ++i)
+			if (buffer[i] == '.')
+				return i;
+
+		return len; // consider vs -1
+	}
+
+	constexpr bool isWildcardCharacter(char c)
+	{
+		return (c == 'X' || c == 'x' || c == '*');
+	}
+
+	enum class NumericIdentifierParseResult : uint8_t
+	{
+		SUCCESS,
+		EMPTY_IDENTIFIER,
+		LEADING_ZERO,
+		NON_DIGIT_CHARACTER,
+		WILDCARD
+	};
+
+	constexpr size_t maxExactDigits = 19; // numeric identifiers up to this long parse exactly into a uint64_t
+	constexpr uint64_t powersOf10[8] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+
+	// values of longer identifiers are UINT64_MAX, over SEMVER_MAX_NUMERIC_IDENTIFIER like those they stand for
+	constexpr NumericIdentifierParseResult parseNumericIdentifier(const char* identifier, size_t len, uint64_t& value)
+	{
+
+		if (!identifier || len == 0)
+			return NumericIdentifierParseResult::EMPTY_IDENTIFIER;
+
+		// single digits are common
+		if (len == 1)
+		{
+			if (isWildcardCharacter(identifier[0]))
+			{
+				value = SEMVER_WILDCARD_IDENTIFIER;
+				return NumericIdentifierParseResult::WILDCARD; // single character wildcard
+			}
+
+			if ((identifier[0] < '0') || (identifier[0] > '9'))
+				return NumericIdentifierParseResult::NON_DIGIT_CHARACTER;
+
+			value = static_cast<uint64_t>(identifier[0]) - '0'; // Convert single digit character to numeric value
+			return NumericIdentifierParseResult::SUCCESS; // Single digit is valid
+		}
+
+		// At this point more than one character, so no wildcards
+		if (identifier[0] == '0')
+			return NumericIdentifierParseResult::LEADING_ZERO; // Leading zero is not allowed for numeric identifiers with more than one digit
+
+		value = 0; // Initialize value to zero
+
+		if (len >= 8) // timestamps and CI build numbers are long, eight digits at a time
+		{
+			size_t i = 0;
+
+			for (; i + 8 <= len; i += 8)
+			{
+				uint64_t chars = simd::loadEight(identifier + i);
+
+				if (!simd::isEightDigits(chars))
+					return NumericIdentifierParseResult::NON_DIGIT_CHARACTER;
+
+				value = value * 100000000 + simd::parseEightDigits(chars);
+			}
+
+			if (size_t rest = len - i) // the last eight characters, with the ones already parsed replaced by zeros
+			{
+				uint64_t parsed = (uint64_t(1) << (8 * (8 - rest))) - 1;
+				uint64_t chars = (simd::loadEight(identifier + len - 8) & ~parsed) | (0x3030303030303030 & parsed);
+
+				if (!simd::isEightDigits(chars))
+					return NumericIdentifierParseResult::NON_DIGIT_CHARACTER;
+
+				value = value * powersOf10[rest] + simd::parseEightDigits(chars);
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < len; ++i)
+			{
+				char c = identifier[i];
+				if ((c < '0') || (c > '9'))
+					return NumericIdentifierParseResult::NON_DIGIT_CHARACTER; // If any character is not a digit, return NON_DIGIT_CHARACTER. 
+
+				value = value * 10 + (static_cast<uint64_t>(c) - '0');
+			}
+		}
+
+		if (len > maxExactDigits) // wrapped around, but more digits than SEMVER_MAX_NUMERIC_IDENTIFIER has
+			value = UINT64_MAX;
+
+		return NumericIdentifierParseResult::SUCCESS;
+	}
+
+	enum class IDENTIFIER_PART_TYPE : uint8_t
+	{
+		UNKNOWN,
+		EMPTY,
+		ALPHANUMERIC,
+		DIGITS,
+		NUMERIC
+	};
+
+
+	constexpr IDENTIFIER_PART_TYPE getIdentifierType(const char* identifier, size_t len)
+	{
+		if (!identifier)
+			return IDENTIFIER_PART_TYPE::EMPTY;
+
+		IDENTIFIER_PART_TYPE result = IDENTIFIER_PART_TYPE::DIGITS;
+
+		for (size_t i = 0; i < len; ++i)
+		{
+			char c = identifier[i];
+			bool isDigit = (c >= '0') && (c <= '9');
+
+			bool isNonDigit = ((c >= 'A') && (c <= 'Z'))
+				|| ((c >= 'a') && (c <= 'z'))
+				|| (c == '-');
+
+			if (!isDigit && !isNonDigit)
+				return IDENTIFIER_PART_TYPE::UNKNOWN;
+
+			if (!isDigit && result == IDENTIFIER_PART_TYPE::DIGITS) // we initilized result to DIGITS
+				result = IDENTIFIER_PART_TYPE::ALPHANUMERIC;
+		}
+
+		// if we still have digits, we check if it start with zero. If not, or if it is a single digit, we return NUMERIC
+		if ((result == IDENTIFIER_PART_TYPE::DIGITS) && ((len == 1) || (identifier[0] != '0')))
+			result = IDENTIFIER_PART_TYPE::NUMERIC;
+
+		return result;
+	}
+
+	constexpr bool isValidNumericIdentifier (const char* identifier, size_t len, uint64_t& value)
+	{
+		return parseNumericIdentifier(identifier, len, value) == NumericIdentifierParseResult::SUCCESS;
+	}
+
+	constexpr int compareNonNumericIdentifiers(const char* lhs, size_t lhsLen, const char* rhs, size_t rhsLen)
+	{
+		size_t compare_len = lhsLen <= rhsLen ? lhsLen : rhsLen;
+
+		for (size_t i = 0; i < compare_len; ++i)
+		{
+			if (lhs[i] != rhs[i])
+				return (lhs[i] < rhs[i]) ? -1 : 1;
+		}
+
+		if (lhsLen != rhsLen) 
+			return (lhsLen < rhsLen) ? -1 : 1;
+	
+		return 0;
+
+	}
+
 	struct Version
 	{
 
@@ -48,20 +280,20 @@ namespace semver
 			WILD
 		};
 
-		void clear();
+		constexpr void clear();
 
 
-		inline bool majorIsWild() const { return major == SEMVER_WILDCARD_IDENTIFIER; }
-		inline bool minorIsWild() const { return minor == SEMVER_WILDCARD_IDENTIFIER; }
-		inline bool patchIsWild() const { return patch == SEMVER_WILDCARD_IDENTIFIER; }
+		constexpr bool majorIsWild() const { return major == SEMVER_WILDCARD_IDENTIFIER; }
+		constexpr bool minorIsWild() const { return minor == SEMVER_WILDCARD_IDENTIFIER; }
+		constexpr bool patchIsWild() const { return patch == SEMVER_WILDCARD_IDENTIFIER; }
 		
-		inline bool majorIsUndefined() const { return major == SEMVER_UNINITIALIZED_IDENTIFIER; }
-		inline bool minorIsUndefined() const { return minor == SEMVER_UNINITIALIZED_IDENTIFIER; }
-		inline bool patchIsUndefined() const { return patch == SEMVER_UNINITIALIZED_IDENTIFIER; }
-		inline bool preReleaseIsUndefined() const { return isPrereleaseInline() && inline_prerelease[0] == SEMVER_UNINITIALIZED_LABEL[0]; }
-		inline bool buildIsUndefined() const { return flags & BUILD_UNDEFINED; }
+		constexpr bool majorIsUndefined() const { return major == SEMVER_UNINITIALIZED_IDENTIFIER; }
+		constexpr bool minorIsUndefined() const { return minor == SEMVER_UNINITIALIZED_IDENTIFIER; }
+		constexpr bool patchIsUndefined() const { return patch == SEMVER_UNINITIALIZED_IDENTIFIER; }
+		constexpr bool preReleaseIsUndefined() const { return isPrereleaseInline() && inline_prerelease[0] == SEMVER_UNINITIALIZED_LABEL[0]; }
+		constexpr bool buildIsUndefined() const { return flags & BUILD_UNDEFINED; }
 
-		inline bool isDefined() const
+		constexpr bool isDefined() const
 		{
 			return major < SEMVER_MAX_NUMERIC_IDENTIFIER &&
 				minor < SEMVER_MAX_NUMERIC_IDENTIFIER &&
@@ -71,17 +303,17 @@ namespace semver
 
 																	
 
-		SemverParseResult parseInternal(const char* str, size_t len, bool ignoreBuild,
+		constexpr SemverParseResult parseInternal(const char* str, size_t len, bool ignoreBuild,
 			UninitializedDefault uninitializedDefault);
 
-		inline SemverParseResult parse(const char* str, size_t len, 
+		constexpr SemverParseResult parse(const char* str, size_t len, 
 			UninitializedDefault uninitializedDefault = UninitializedDefault::TAG)
 		{
 			constexpr bool ignoreBuild_FALSE = false;
 			return parseInternal(str, len, ignoreBuild_FALSE, uninitializedDefault);
 		}
 
-		inline SemverParseResult parseIgnoreBuild(const char* str, size_t len, 
+		constexpr SemverParseResult parseIgnoreBuild(const char* str, size_t len, 
 			UninitializedDefault uninitializedDefault = UninitializedDefault::TAG)
 		{
 			constexpr bool ignoreBuild_TRUE = true;
@@ -101,36 +333,36 @@ namespace semver
 			DIGITS_WITH_LEADING_ZERO = SEMVER_PARSE_PRERELEASE_LEADING_ZERO_ON_NUMERIC_IDENTIFIER,
 		};
 
-		PreleaseParseResult trySetPrerelease(const char* str, size_t len);
-		PreleaseParseResult trySetPrerelease(const char* str) { return trySetPrerelease(str, strlenSafe(str)); }
+		constexpr PreleaseParseResult trySetPrerelease(const char* str, size_t len);
+		constexpr PreleaseParseResult trySetPrerelease(const char* str) { return trySetPrerelease(str, strlenSafe(str)); }
 
 
-		static PreleaseParseResult parsePrerelease(const char* buffer, size_t len);
-		inline static PreleaseParseResult parsePrerelease(const char* buffer) { return Version::parsePrerelease(buffer, strlenSafe(buffer)); }
+		static constexpr PreleaseParseResult parsePrerelease(const char* buffer, size_t len);
+		static constexpr PreleaseParseResult parsePrerelease(const char* buffer) { return Version::parsePrerelease(buffer, strlenSafe(buffer)); }
 
-		PreleaseParseResult parsePrerelease() const { return Version::parsePrerelease(getPrerelease()); }
+		constexpr PreleaseParseResult parsePrerelease() const { return Version::parsePrerelease(getPrerelease()); }
 
 
-		void setPrerelease(const char* str, size_t len);
+		constexpr void setPrerelease(const char* str, size_t len);
 		
-		void setPrerelease(const char* str) 
+		constexpr void setPrerelease(const char* str) 
 			{ setPrerelease(str, strlenSafe(str)); }
 		
-		void deletePrerelease();
+		constexpr void deletePrerelease();
 		
-		inline bool isPrereleaseOnHeap() const 	{ return flags & PRERELEASE_ON_HEAP; }
+		constexpr bool isPrereleaseOnHeap() const 	{ return flags & PRERELEASE_ON_HEAP; }
 
-		inline bool isPrereleaseInline() const { return !(flags & PRERELEASE_ON_HEAP); }
+		constexpr bool isPrereleaseInline() const { return !(flags & PRERELEASE_ON_HEAP); }
 	
 		inline const char* get_heap_prerelease() const 
 		{ 
 			return *reinterpret_cast<const char* const*>(&inline_prerelease[heap_prerelease_pad]); // so it aligns to a 64-bit boundary
 		} 
 
-		inline const char* getPrerelease() const { return isPrereleaseOnHeap() ? get_heap_prerelease(): inline_prerelease; }
+		constexpr const char* getPrerelease() const { return isPrereleaseOnHeap() ? get_heap_prerelease(): inline_prerelease; }
 
-		inline void setPrereleaseInline() { flags &= ~PRERELEASE_ON_HEAP; }
-		inline void setPrereleaseOnHeap() { flags |= PRERELEASE_ON_HEAP; }
+		constexpr void setPrereleaseInline() { flags &= ~PRERELEASE_ON_HEAP; }
+		constexpr void setPrereleaseOnHeap() { flags |= PRERELEASE_ON_HEAP; }
 
 		void setHeapPrerelease(const char* ptr)
 		{
@@ -151,11 +383,11 @@ namespace semver
 			UNSUPPORTED_CHARACTER = SEMVER_PARSE_BUILD_UNSUPPORTED_CHARACTER,
 		};
 
-		BuildParseResult trySetBuild(const char* str, size_t len);
-		BuildParseResult trySetBuild(const char* str) { return trySetBuild(str, strlenSafe(str)); }
+		constexpr BuildParseResult trySetBuild(const char* str, size_t len);
+		constexpr BuildParseResult trySetBuild(const char* str) { return trySetBuild(str, strlenSafe(str)); }
 
-		static Version::BuildParseResult parseBuild(const char* buffer, size_t len);
-		inline static Version::BuildParseResult parseBuild(const char* buffer) { return Version::parseBuild(buffer, strlenSafe(buffer)); }
+		static constexpr Version::BuildParseResult parseBuild(const char* buffer, size_t len);
+		static constexpr Version::BuildParseResult parseBuild(const char* buffer) { return Version::parseBuild(buffer, strlenSafe(buffer)); }
 
 		Version::BuildParseResult parseBuild() const { return Version::parseBuild(getBuild()); }
 		
@@ -166,53 +398,68 @@ namespace semver
 		
 		void deleteBuild();
 
-		inline bool hasBuild() const { return flags & BUILD_IN_MAP; }
-		inline bool isPrerelease() const;
+		// builds are keyed on the Version address, so moving a Version needs to move its build too
+		const char* detachBuild(); // removes the build from this Version without freeing it
+		void attachBuild(const char* build); // takes ownership of a build returned by detachBuild
+		void moveTo(Version& destination); // destination must not hold heap resources, this Version is left empty
+		void copyFrom(const Version& other); // deep copy, including prerelease and build
+
+		constexpr bool hasBuild() const { return flags & BUILD_IN_MAP; }
+		constexpr bool isPrerelease() const
+		{
+			return isPrereleaseOnHeap() ||
+				inline_prerelease[0] != SEMVER_UNINITIALIZED_LABEL[0] &&
+				inline_prerelease[0] != '\0';
+		}
 
 		const char* getBuild() const;
 	
 		// Operators/ Comparison
 		////////////////////////
-		inline bool sameCore(const Version& other) const { return major == other.major && minor == other.minor && patch == other.patch; }
+		constexpr bool sameCore(const Version& other) const { return major == other.major && minor == other.minor && patch == other.patch; }
 
 		inline bool operator==(const Version& other) const
 		{
 			return sameCore(other) && strcmp(getPrerelease(), other.getPrerelease()) == 0; // builds are not compared
 		};
 
-		inline bool operator<(const Version& other) const
+		constexpr bool operator<(const Version& other) const
 		{
 			return Version::compare(*this, other) < 0;
 		}
 		
-		inline bool operator>(const Version& other) const
+		constexpr bool operator>(const Version& other) const
 		{
 			return Version::compare(*this, other) > 0;
 		}
 
-		inline bool operator<=(const Version& other) const
+		constexpr bool operator<=(const Version& other) const
 		{
 			return Version::compare(*this, other) <= 0;
 		}
 
-		inline bool operator>=(const Version& other) const
+		constexpr bool operator>=(const Version& other) const
 		{
 			return Version::compare(*this, other) >= 0;
 		}
 
 
-		static int comparePrereleases(const char* lhs, const char* rhs);
+		static constexpr int comparePrereleases(const char* lhs, const char* rhs);
 
-		static int compare(const Version& lhs, const Version& rhs);
+		static constexpr int compareCores(const Version& lhs, const Version& rhs); // major, minor and patch only
+
+		static constexpr int compare(const Version& lhs, const Version& rhs);
 
 
 		// Cleanup
 		//////////
 
-		inline void deleteHeapResources() 
+		constexpr void deleteHeapResources() 
 		{ 
 			deletePrerelease(); 
-			deleteBuild();
+
+			if (hasBuild())
+				deleteBuild(); // not a constant expression: builds are kept outside of the Version
 		}
 
 		// Interpreted Info
@@ -220,8 +467,10 @@ namespace semver
 
 
 		std::string toString() const;
+		void format(FormatBuffer& out) const;
+		size_t formattedLength() const;
 
-		inline bool isMaximum() const
+		constexpr bool isMaximum() const
 		{
 			return 
 				major == SEMVER_MAX_NUMERIC_IDENTIFIER &&
@@ -229,14 +478,15 @@ namespace semver
 				patch == SEMVER_MAX_NUMERIC_IDENTIFIER;
 		}
 
-		inline bool isMinimum() const
+		constexpr bool isMinimum() const
 		{
 			return 
 				major == 0 &&
 				minor == 0 &&
 				patch == 0 &&
 				isPrereleaseInline() &&
-				inline_prerelease[0] == SEMVER_LOWEST_PRERELEASE[0];
+				inline_prerelease[0] == SEMVER_LOWEST_PRERELEASE[0] &&
+				inline_prerelease[1] == '\0'; // 0.0.0-0-1 and 0.0.0-0.1 are above the minimum
 		}
 
 
@@ -253,4 +503,488 @@ namespace semver
 	static_assert(std::is_trivially_copyable<semver::Version>::value, "Version must be trivially copyable"); // no RAII we manage heap
 
 
-}
\ No newline at end of file
+	// constexpr members, defined here so they can be evaluated at compile time
+	////////////////////////////////////////////////////////////////////////////
+
+	constexpr void Version::clear()
+	{
+		deletePrerelease();
+
+		if (hasBuild())
+			deleteBuild();
+
+		major = minor = patch = 0;
+		flags = 0;
+	}
+
+	constexpr SemverParseResult Version::parseInternal(const char* str, size_t len, bool ignoreBuild, // I only approve of boolean arguments on internal methods
+		UninitializedDefault uninitializedDefault)
+	{
+
+		stats::count(stats::VERSION_PARSES);
+		SemverParseResult result = SEMVER_PARSE_SUCCESS;
+
+		if (flags & Flags::MANAGED)
+		{
+			clear();
+			flags |= Flags::MANAGED; //restore the flag
+		}
+		else
+			clear();
+
+		if (uninitializedDefault == UninitializedDefault::TAG)
+		{
+			major = minor = patch = SEMVER_UNINITIALIZED_IDENTIFIER;
+			inline_prerelease[0] = SEMVER_UNINITIALIZED_LABEL[0]; // memset made the rest \0
+
+			flags |= BUILD_UNDEFINED;
+		}
+		else if (uninitializedDefault == UninitializedDefault::WILD)
+		{
+			major = minor = patch = SEMVER_WILDCARD_IDENTIFIER;
+		}
+
+		size_t start = 0;
+
+		if (strEmpty(str) || len == 0) // slices of a larger buffer can be empty without being \0 terminated
+			return  SEMVER_PARSE_EMPTY_VERSION_STRING; //terminal
+
+
+		if (str[start] <= ' ')
+		{
+			result = SEMVER_PARSE_LEADING_WHITESPACE; // non terminal
+
+			while (str[start] <= ' ' && start < len - 1)
+				++start;
+
+			if (start == len - 1)
+				return SEMVER_PARSE_EMPTY_VERSION_STRING; //only whitespace, but seems appropriate
+		}
+
+		const char* versionstr = str + start; // versionstr starts after whitespace
+		len -= start;
+		// beyond this point use versionstr instead of str
+
+		if (versionstr[len - 1] <= ' ')
+		{
+			result = SEMVER_PARSE_TRAILING_WHITESPACE; // non terminal
+
+			while (versionstr[len - 1] <= ' ' && len > 1)
+				--len;
+		}
+
+		// end is just past end of version or at first whitespace
+
+		if (isWildcardCharacter(versionstr[0])) // If the first character is a wildcard, we don't check the rest of the string 
+		{
+
+			if (len == 1 || versionstr[1] == '.')
+			{
+				major = SEMVER_WILDCARD_IDENTIFIER;
+				return SEMVER_PARSE_MAJOR_WILDCARD;
+			}
+
+			return SEMVER_PARSE_MAJOR_NOT_NUMERIC; // we are sure if wild becase it was not a single widcard char
+		}
+
+
+		size_t dot1 = getDotPos(versionstr, len);
+
+		switch (parseNumericIdentifier(versionstr, dot1, major)) // dot1 is also majorLength
+		{
+		case NumericIdentifierParseResult::SUCCESS:
+			if (major > SEMVER_MAX_NUMERIC_IDENTIFIER)
+				return SEMVER_PARSE_MAJOR_TOO_LARGE;
+
+			break;
+
+		case NumericIdentifierParseResult::EMPTY_IDENTIFIER:
+			return SEMVER_PARSE_MAJOR_EMPTY;
+
+		case NumericIdentifierParseResult::LEADING_ZERO:
+			return SEMVER_PARSE_MAJOR_LEADING_ZERO;
+
+		case NumericIdentifierParseResult::NON_DIGIT_CHARACTER:
+			return SEMVER_PARSE_MAJOR_NOT_NUMERIC;
+
+		case NumericIdentifierParseResult::WILDCARD:
+			return SEMVER_PARSE_MAJOR_WILDCARD; // if we do not allow wildcards, return an error
+		}
+
+		if (dot1 == len)
+			return SEMVER_PARSE_TOO_FEW_PARTS;
+
+
+		size_t dot2 = getDotPosEx(versionstr, len, dot1 + 1); // cannot have two adjacent dots
+		size_t minorLength = dot2 - dot1 - 1;
+
+		switch (parseNumericIdentifier(versionstr + dot1 + 1, minorLength, minor))
+		{
+		case NumericIdentifierParseResult::SUCCESS:
+			if (minor > SEMVER_MAX_NUMERIC_IDENTIFIER) // wildcards also satisfy this criteria, but parsing reports wildcard not success in that case
+				return SEMVER_PARSE_MINOR_TOO_LARGE;
+
+			if (dot2 == len) //never saw a second dot, so the number is 1.2 form
+				return(SEMVER_PARSE_TOO_FEW_PARTS);
+
+			break;
+
+		case NumericIdentifierParseResult::EMPTY_IDENTIFIER:
+			return SEMVER_PARSE_MINOR_EMPTY;
+
+		case NumericIdentifierParseResult::LEADING_ZERO:
+			return SEMVER_PARSE_MINOR_LEADING_ZERO;
+
+		case NumericIdentifierParseResult::NON_DIGIT_CHARACTER:
+			return SEMVER_PARSE_MINOR_NOT_NUMERIC;
+
+		case NumericIdentifierParseResult::WILDCARD:
+			return SEMVER_PARSE_MINOR_WILDCARD; // if we do not allow wildcards, return an error
+		}
+
+		//const char* versionremainder = versionstr + dot2 + 1;
+		//size_t remainderlen = len - dot2 - 1;
+
+
+		size_t buildPos = getCharPosEx('+', versionstr, len, dot2 + 1); // + is followed by build
+		bool hasBuild = (buildPos != len);
+
+		size_t prereleasePos = getCharPosEx('-', versionstr, len, dot2 + 1); // followed by pre-release and optionally a + and the build
+		bool isPrerelease = prereleasePos < buildPos; // buildpos is len if not found
+
+
+		size_t patchEnd;
+
+		if (isPrerelease)
+			patchEnd = prereleasePos;
+		else if (hasBuild)
+			patchEnd = buildPos;
+		else
+		{
+			patchEnd = len;
+
+			if (getDotPosEx(versionstr, len, dot2 + 1) != len)
+				return SEMVER_PARSE_TOO_MANY_PARTS;
+		}
+
+		switch (parseNumericIdentifier(versionstr + dot2 + 1, patchEnd - dot2 - 1, patch))
+		{
+		case NumericIdentifierParseResult::SUCCESS:
+			if (patch > SEMVER_MAX_NUMERIC_IDENTIFIER)
+				return SEMVER_PARSE_PATCH_TOO_LARGE;
+			break;
+
+		case NumericIdentifierParseResult::EMPTY_IDENTIFIER:
+			return SEMVER_PARSE_PATCH_EMPTY;
+
+		case NumericIdentifierParseResult::LEADING_ZERO:
+			return SEMVER_PARSE_PATCH_LEADING_ZERO;
+
+		case NumericIdentifierParseResult::NON_DIGIT_CHARACTER:
+			return SEMVER_PARSE_PATCH_NOT_NUMERIC;
+
+		case NumericIdentifierParseResult::WILDCARD:
+			return SEMVER_PARSE_PATCH_WILDCARD; // if we do not allow wildcards, return an error
+		}
+
+
+		if (isPrerelease)
+		{
+			size_t pre_release_len = buildPos - prereleasePos - 1; // if no build, builtPos is set to the remainderLength
+
+			PreleaseParseResult preReleaseParseResult = trySetPrerelease(versionstr + prereleasePos + 1, pre_release_len);
+
+			if (preReleaseParseResult != PreleaseParseResult::SUCCESS)
+				return static_cast<SemverParseResult>(preReleaseParseResult);
+
+		}
+		else
+			inline_prerelease[0] = '\0'; // if we set first char to ? rest it to \0
+
+		if (hasBuild && !ignoreBuild)
+		{
+			size_t build_len = len - buildPos - 1;
+			BuildParseResult buildParseResult = trySetBuild(versionstr + buildPos + 1, build_len);
+
+			if (buildParseResult != BuildParseResult::SUCCESS)
+				return static_cast<SemverParseResult>(buildParseResult);
+
+		}
+		else
+			flags &= ~(BUILD_UNDEFINED | BUILD_IN_MAP);
+
+		return result;
+	}
+
+	constexpr Version::PreleaseParseResult Version::trySetPrerelease(const char* str, size_t len)
+	{
+		auto result = Version::parsePrerelease(str, len);
+
+		if (result == PreleaseParseResult::SUCCESS)
+			setPrerelease(str, len);
+		else
+		    setPrerelease(SEMVER_UNINITIALIZED_LABEL, 1);
+	
+		return result;
+	}
+
+	constexpr Version::PreleaseParseResult Version::parsePrerelease(const char* buffer, size_t len)
+	{
+		if (len == 0)
+			return PreleaseParseResult::SUCCESS; // empty prerelease is valid
+
+		if (!std::is_constant_evaluated() && len >= simd::minIdentifiersLength && simd::validIdentifiers(buffer, len, true))
+			return PreleaseParseResult::SUCCESS; // else the identifiers are checked one by one to find the error
+
+		size_t start = 0;
+		do
+		{
+			size_t remaining_len = len - start;
+			size_t dotpos = getDotPos(buffer + start, remaining_len);
+
+
+			if (dotpos == 0 || dotpos == remaining_len - 1) // last character is a dot
+				return PreleaseParseResult::EMPTY_IDENTIFIER;
+
+			size_t identifierlen = dotpos == -1 ? remaining_len : dotpos;
+
+			// must be alphanumeric, but if all digits it must be numeric (cannot start with 0 if more than one character)
+			auto identifierType = getIdentifierType(buffer + start, identifierlen);
+			switch (identifierType)
+			{
+			case IDENTIFIER_PART_TYPE::ALPHANUMERIC:
+			case IDENTIFIER_PART_TYPE::NUMERIC: // exludes digits with leading zero
+				break;
+
+			case IDENTIFIER_PART_TYPE::EMPTY:
+				return PreleaseParseResult::EMPTY_IDENTIFIER;
+
+			case IDENTIFIER_PART_TYPE::DIGITS: // we distinguish between digits and numeric when parsing (digits without a leading zero are numeric)
+				return PreleaseParseResult::DIGITS_WITH_LEADING_ZERO;
+
+
+			default: //case IDENTIFIER_PART_TYPE::UNKNOWN:
+				return PreleaseParseResult::UNSUPPORTED_CHARACTER;
+			}
+
+
+			start += identifierlen + 1; //also skip the dot
+		} while (start < len);
+
+		return PreleaseParseResult::SUCCESS;
+	}
+
+	constexpr void Version::setPrerelease(const char* str, size_t len)
+	{
+		deletePrerelease(); // also sets as inline
+		if (len < inline_prerelease_len)
+		{
+			std::copy_n(str, len, inline_prerelease);
+			inline_prerelease[len] = '\0';
+		}
+		else
+		{
+			stats::count(stats::PRERELEASE_HEAP_SPILLS);
+			setHeapPrerelease(cloneStr(str, len)); // not a constant expression: static versions keep their prerelease inline
+		}
+	}
+
+
+	constexpr void Version::deletePrerelease()
+	{
+		if (isPrereleaseOnHeap())
+		{
+			delete[] get_heap_prerelease();
+
+			flags &= ~PRERELEASE_ON_HEAP;
+		}
+
+		std::fill_n(inline_prerelease, inline_prerelease_len, '\0');
+
+	}
+
+	constexpr Version::BuildParseResult Version::trySetBuild(const char* str, size_t len)
+	{
+		BuildParseResult result = Version::parseBuild(str, len);
+
+		if (result == BuildParseResult::SUCCESS)
+			setBuild(str, len); // not a constant expression: builds are kept outside the Version
+		else
+		{
+			if (hasBuild())
+				deleteBuild();
+
+			flags |= BUILD_UNDEFINED; //undefined := '?'
+		}
+
+		return result;
+	}
+
+	constexpr Version::BuildParseResult Version::parseBuild(const char* buffer, size_t len)
+	{
+		if (len == 0)
+			return BuildParseResult::SUCCESS; // empty prerelease is valid
+
+		if (!std::is_constant_evaluated() && len >= simd::minIdentifiersLength && simd::validIdentifiers(buffer, len, false))
+			return BuildParseResult::SUCCESS; // long builds, such as commit hashes, are common
+
+		size_t start = 0;
+		do
+		{
+			size_t remaining_len = len - start;
+			size_t dotpos = getDotPos(buffer + start, remaining_len);
+
+
+			if (dotpos == 0 || dotpos == remaining_len - 1) // first character of identifier is dot (two dots in a row) or last character is a dot
+				return BuildParseResult::EMPTY_IDENTIFIER;
+
+
+			size_t identifierlen = dotpos == -1 ? remaining_len : dotpos;
+
+			// must be alphanumeric, but if all digits it must be numeric (cannot start with 0 if more than one character)
+			auto identifierType = getIdentifierType(buffer + start, identifierlen);
+			switch (identifierType)
+			{
+			case IDENTIFIER_PART_TYPE::ALPHANUMERIC:
+			case IDENTIFIER_PART_TYPE::DIGITS:
+			case IDENTIFIER_PART_TYPE::NUMERIC:
+				break;
+
+
+			case IDENTIFIER_PART_TYPE::EMPTY:
+				return BuildParseResult::EMPTY_IDENTIFIER;
+
+			default: //case IDENTIFIER_PART_TYPE::UNKNOWN:
+				return BuildParseResult::UNSUPPORTED_CHARACTER;
+			}
+
+
+			start += identifierlen + 1; //also skip the dot
+		} while (start < len);
+
+		return BuildParseResult::SUCCESS;
+
+	}
+
+	constexpr int Version::comparePrereleases(const char* lhs, const char* rhs)
+	{
+
+		if (lhs == rhs)
+			return 0;
+
+		if (!lhs || !(*lhs)) // no pre-release > pre-release
+			return -1;
+
+		if (!rhs || !(*rhs))
+			return 1;
+
+		size_t lhs_start = 0;
+		size_t lhs_len = std::char_traits<char>::length(lhs);
+		size_t rhs_start = 0;
+		size_t rhs_len = std::char_traits<char>::length(rhs);
+
+		do
+		{
+			size_t lhs_remaining_len = lhs_len - lhs_start;
+			size_t rhs_remaining_len = rhs_len - rhs_start;
+
+
+			size_t lhs_dotpos = getDotPos(lhs + lhs_start, lhs_remaining_len);
+			size_t rhs_dotpos = getDotPos(rhs + rhs_start, rhs_remaining_len);
+
+
+			size_t lhs_identiferlen = lhs_dotpos == -1 ? lhs_remaining_len : lhs_dotpos;
+			size_t rhs_identiferlen = rhs_dotpos == -1 ? rhs_remaining_len : rhs_dotpos;
+
+			uint64_t lhs_numeric_identifier;
+			bool lhs_numeric = isValidNumericIdentifier(lhs + lhs_start, lhs_identiferlen, lhs_numeric_identifier);
+
+			uint64_t rhs_numeric_identifier;
+			bool rhs_numeric = isValidNumericIdentifier(rhs + rhs_start, rhs_identiferlen, rhs_numeric_identifier);
+
+
+			if (lhs_numeric && rhs_numeric)
+			{
+				if (lhs_numeric_identifier != rhs_numeric_identifier)
+					return lhs_numeric_identifier < rhs_numeric_identifier ? -1 : 1;
+
+				if (lhs_identiferlen > maxExactDigits) // both too long to parse, without leading zeros more digits is larger
+				{
+					if (lhs_identiferlen != rhs_identiferlen)
+						return lhs_identiferlen < rhs_identiferlen ? -1 : 1;
+
+					int comparison = compareNonNumericIdentifiers(lhs + lhs_start, lhs_identiferlen, rhs + rhs_start, rhs_identiferlen);
+
+					if (comparison != 0)
+						return comparison;
+				}
+			}
+			else
+			{
+				if (lhs_numeric) // if one is numeric it has lower precendence
+					return -1;
+
+				if (rhs_numeric)
+					return 1;
+
+				int comparison = compareNonNumericIdentifiers(lhs + lhs_start, lhs_identiferlen,
+															  rhs + rhs_start, rhs_identiferlen);
+
+				if (comparison != 0)
+					return comparison; // else we need to check for more identifiers e.g. alpha.1 vs alpha.2 should not exit with 0 here
+			}
+
+
+			lhs_start += lhs_identiferlen + 1; //also skip the dot with +1
+			rhs_start += rhs_identiferlen + 1;
+
+
+		} while ((lhs_start < lhs_len) && (rhs_start < rhs_len));
+
+		if (lhs_len != rhs_len)
+			return lhs_len < rhs_len ? -1 : 1; // longer chains have higher precedence if all earlier sections match
+
+		return 0;
+	}
+
+
+	constexpr int Version::compareCores(const Version& lhs, const Version& rhs)
+	{
+		if (lhs.major != rhs.major)
+			return (lhs.major < rhs.major) ? -1 : 1;
+
+		if (lhs.minor != rhs.minor)
+			return (lhs.minor < rhs.minor) ? -1 : 1;
+
+		if (lhs.patch != rhs.patch)
+			return (lhs.patch < rhs.patch) ? -1 : 1;
+
+		return 0;
+	}
+
+	constexpr int Version::compare(const Version& lhs, const Version& rhs)
+	{
+		stats::count(stats::VERSION_COMPARES);
+		int coreComparison = compareCores(lhs, rhs);
+
+		if (coreComparison != 0)
+			return coreComparison;
+
+		if (std::equal(lhs.inline_prerelease, lhs.inline_prerelease + inline_prerelease_len, rhs.inline_prerelease)) //this means that if we set the heap prerelease we need to also clear the characters in front of the pointer
+			return 0;
+
+		// prerelease have lower precedence than non-prerelease
+		// consider pre-releases a negative offset to the version to the left of them
+
+		if (lhs.isPrerelease() && !rhs.isPrerelease())
+			return -1; // lhs is prerelease, rhs is not, so lhs < rhs
+
+		if (!lhs.isPrerelease() && rhs.isPrerelease())
+			return 1; // lhs is not prerelease, rhs is, so lhs > rhs
+
+
+		stats::count(stats::PRERELEASE_COMPARES);
+		return comparePrereleases(lhs.getPrerelease(), rhs.getPrerelease()); // versions are equal
+	}
+
+}
@@ -0,0 +1,179 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+// Looks up single versions in a large sorted array, the way a registry resolves exact pins: each lookup binary searches
+// the whole array, touching pages far apart. Compares an array on the heap with one on transparent huge pages, and a
+// replica on the node of the calling thread. Reports the cost and the data TLB misses per lookup (where the kernel
+// exposes the counter), and how much of the array huge pages back. Usage: semver_block_bench [versions] [lookups]
+
+#include "API/semver.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <cstring>
+#include <fstream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+// data TLB read misses of this thread in user space, while started. -1 where the counter can't be opened
+class TlbMisses
+{
+public:
+
+	TlbMisses()
+	{
+#ifdef __linux__
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+	}
+
+	~TlbMisses()
+	{
+#ifdef __linux__
+		if (fd >= 0)
+			close(fd);
+#endif
+	}
+
+	void start()
+	{
+#ifdef __linux__
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	int64_t stop()
+	{
+#ifdef __linux__
+		uint64_t count = 0;
+
+		if (fd >= 0 && ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) == 0 && read(fd, &count, sizeof(count)) == sizeof(count))
+			return static_cast<int64_t>(count);
+#endif
+		return -1;
+	}
+
+private:
+
+	int fd = -1;
+};
+
+static size_t hugePagesKb() // anonymous memory of the process backed by huge pages
+{
+#ifdef __linux__
+	std::ifstream rollup("/proc/self/smaps_rollup");
+	std::string line;
+
+	while (std::getline(rollup, line))
+		if (line.compare(0, 14, "AnonHugePages:") == 0)
+			return std::strtoull(line.c_str() + 14, nullptr, 10);
+#endif
+	return 0;
+}
+
+static size_t hugePagesAddedMb(size_t kbBefore)
+{
+	size_t kb = hugePagesKb();
+	return (kb > kbBefore) ? (kb - kbBefore) / 1024 : 0;
+}
+
+static void benchLookups(const char* title, HSemverVersions versions, const std::vector<HSemverQuery>& pins, size_t lookups, size_t hugeMb)
+{
+	TlbMisses tlb;
+	size_t found = 0;
+
+	Clock::time_point start = Clock::now();
+	tlb.start();
+
+	for (size_t i = 0; i < lookups; ++i)
+	{
+		HSemverVersions match = semver_query_match_versions(pins[i % pins.size()], versions);
+		found += semver_versions_count(match);
+		semver_versions_dispose(match);
+	}
+
+	int64_t misses = tlb.stop();
+	double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / lookups;
+
+	if (misses >= 0)
+		printf("%-34s %8.1f ns/lookup %8.2f dTLB misses/lookup %6zu MB huge pages  (%zu found)\n", title, ns, double(misses) / lookups, hugeMb, found);
+	else
+		printf("%-34s %8.1f ns/lookup %8s dTLB misses/lookup %6zu MB huge pages  (%zu found)\n", title, ns, "n/a", hugeMb, found);
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = (argc > 1) ? static_cast<size_t>(atol(argv[1])) : 4000000;
+	size_t lookups = (argc > 2) ? static_cast<size_t>(atol(argv[2])) : 1000000;
+
+	std::string versions_str;
+	versions_str.reserve(count * 12);
+
+	for (size_t i = 0; i < count; ++i)
+		versions_str += std::to_string(i / 1000000) + "." + std::to_string(i / 1000 % 1000) + "." + std::to_string(i % 1000) + ",";
+
+	std::mt19937_64 random(1);
+	std::vector<HSemverQuery> pins;
+
+	for (size_t i = 0; i < 4096; ++i)
+	{
+		size_t at = random() % count;
+		std::string pin = std::to_string(at / 1000000) + "." + std::to_string(at / 1000 % 1000) + "." + std::to_string(at % 1000);
+		pins.push_back(semver_query_create());
+		semver_query_parse(pins.back(), pin.c_str());
+	}
+
+	printf("%zu versions (%zu MB), %zu lookups\n", count, count * 40 >> 20, lookups);
+
+	size_t hugeKb = hugePagesKb(); // the huge pages each array added
+	HSemverVersions heap = semver_versions_from_string(versions_str.c_str(), ",", SEMVER_ORDER_ASC);
+	benchLookups("heap", heap, pins, lookups, hugePagesAddedMb(hugeKb));
+	semver_versions_dispose(heap);
+
+	SemverAllocation allocation{ TRUE, -1 };
+	semver_versions_set_allocation(&allocation);
+
+	hugeKb = hugePagesKb();
+	HSemverVersions huge = semver_versions_from_string(versions_str.c_str(), ",", SEMVER_ORDER_ASC);
+	benchLookups("huge pages", huge, pins, lookups, hugePagesAddedMb(hugeKb));
+
+	int node = semver_current_numa_node();
+	std::string replicaTitle = "huge pages, replica on node " + std::to_string(node);
+
+	hugeKb = hugePagesKb();
+	HSemverVersions replica = semver_versions_replicate(huge, node);
+	size_t replicaHugeMb = hugePagesAddedMb(hugeKb);
+	semver_versions_dispose(huge);
+
+	benchLookups(replicaTitle.c_str(), replica, pins, lookups, replicaHugeMb);
+	semver_versions_dispose(replica);
+
+	semver_versions_set_allocation(nullptr);
+
+	for (HSemverQuery pin : pins)
+		semver_query_dispose(pin);
+
+	return 0;
+}
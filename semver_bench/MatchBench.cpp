@@ -0,0 +1,74 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+// Matches versions against single queries, the way a registry checks many releases against a constraint: stable-only
+// queries (caret, tilde, ranges), and queries with prerelease junctures or a minimum prerelease, against a mix of
+// stable versions and prereleases. Reports the cost per match. Usage: semver_match_bench [rounds]
+
+#include "API/semver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static std::vector<HSemverVersion> makeVersions(size_t count, unsigned prereleasePercent, std::mt19937& random)
+{
+	const char* tags[] = { "alpha", "beta.1", "rc.2", "0" };
+	std::vector<HSemverVersion> versions;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const char* prerelease = (random() % 100 < prereleasePercent) ? tags[random() % 4] : "";
+		versions.push_back(semver_version_create_defined(random() % 4, random() % 10, random() % 10, prerelease, ""));
+	}
+
+	return versions;
+}
+
+static void benchQueries(const char* title, const std::vector<const char*>& queries, const std::vector<HSemverVersion>& versions, size_t rounds)
+{
+	HSemverQuery query = semver_query_create();
+	size_t matched = 0;
+	double ns = 0;
+
+	for (const char* query_str : queries)
+	{
+		semver_query_parse(query, query_str);
+		Clock::time_point start = Clock::now();
+
+		for (size_t r = 0; r < rounds; ++r)
+			for (HSemverVersion version : versions)
+				matched += semver_query_matches_version(query, version);
+
+		ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	}
+
+	printf("%-42s %7.2f ns/match  (%zu matched)\n", title, ns / (queries.size() * rounds * versions.size()), matched);
+	semver_query_dispose(query);
+}
+
+int main(int argc, char** argv)
+{
+	size_t rounds = (argc > 1) ? static_cast<size_t>(atol(argv[1])) : 200;
+	std::mt19937 random(1);
+
+	std::vector<const char*> stableOnly = { "^1.2.3", "~2.4", ">=1.0.0 <2.0.0", "1.x || >=3.1.0", "^0.3.1 || ^1.0.0 || ^2.0.0" };
+	std::vector<const char*> withPrereleases = { "^1.2.3-beta", "~2.4 @rc", ">=1.0.0-alpha <2.0.0", "1.x @beta || >=3.1.0", "^0.3.1 || ^1.0.0-0 || ^2.0.0 @0" };
+
+	for (unsigned prereleasePercent : { 0, 20 })
+	{
+		std::vector<HSemverVersion> versions = makeVersions(10000, prereleasePercent, random);
+		std::string suffix = " (" + std::to_string(prereleasePercent) + "% prereleases)";
+
+		benchQueries(("stable-only queries" + suffix).c_str(), stableOnly, versions, rounds);
+		benchQueries(("queries with prereleases" + suffix).c_str(), withPrereleases, versions, rounds);
+
+		for (HSemverVersion version : versions)
+			semver_version_dispose(version);
+	}
+
+	return 0;
+}
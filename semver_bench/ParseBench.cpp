@@ -0,0 +1,66 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+// Parses queries the way a worker checking many constraints does: either a new query handle per string, or one
+// handle re-parsed for every string. Then parses versions with long prereleases and builds, as CI produces them.
+// Reports the cost per parse. Usage: semver_parse_bench [rounds]
+
+#include "API/semver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double nsPerParse(Clock::time_point start, size_t parses)
+{
+	return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / parses;
+}
+
+int main(int argc, char** argv)
+{
+	size_t rounds = (argc > 1) ? static_cast<size_t>(atol(argv[1])) : 200000;
+
+	std::vector<const char*> queries = { "^1.2.3", "~2.4", ">=1.0.0 <2.0.0", "1.x || >=3.1.0 @rc", "^0.3.1 || ^1.0.0 || ^2.0.0",
+		">=1.0.0-alpha.integration.build <2.0.0 @release-candidate" }; // the last one does not fit inline
+	size_t parses = rounds * queries.size();
+	size_t failed = 0;
+
+	Clock::time_point start = Clock::now();
+
+	for (size_t r = 0; r < rounds; ++r)
+		for (const char* query_str : queries)
+		{
+			HSemverQuery query = semver_query_create();
+			failed += semver_query_parse(query, query_str) != SEMVER_QUERY_PARSE_SUCCESS;
+			semver_query_dispose(query);
+		}
+
+	printf("%-30s %7.2f ns/parse\n", "new query per parse", nsPerParse(start, parses));
+
+	HSemverQuery query = semver_query_create();
+	start = Clock::now();
+
+	for (size_t r = 0; r < rounds; ++r)
+		for (const char* query_str : queries)
+			failed += semver_query_parse(query, query_str) != SEMVER_QUERY_PARSE_SUCCESS;
+
+	printf("%-30s %7.2f ns/parse\n", "re-parsed query", nsPerParse(start, parses));
+	semver_query_dispose(query);
+
+	std::vector<const char*> versions = { "1.4.0-nightly.20250611.build-4417", "2.0.0-rc.1+sha.9f86d081884c7d659a2feaa0c55ad015a3bf4f1b",
+		"0.9.12+ci.38271.branch-feature-parser.9f86d081884c", "3.1.4-beta.2", "20261016.0.20261016123045" };
+	parses = rounds * versions.size();
+
+	HSemverVersion version = semver_version_create();
+	start = Clock::now();
+
+	for (size_t r = 0; r < rounds; ++r)
+		for (const char* version_str : versions)
+			failed += semver_version_parse(version, version_str) != SEMVER_PARSE_SUCCESS;
+
+	printf("%-30s %7.2f ns/parse\n", "re-parsed version", nsPerParse(start, parses));
+	semver_version_dispose(version);
+
+	return failed != 0;
+}
@@ -0,0 +1,122 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+// Resolves synthetic package graphs: every package has a few majors with several minors each, and every version
+// depends on a few packages further down the graph with caret or range queries on its own major. Some lag a major
+// behind, mostly in the older minors of a major, so the solver has to backtrack now and then. Usage: semver_bench [packages] [seed]
+
+#include "API/semver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void benchGraph(size_t packageCount, unsigned seed)
+{
+	const size_t majors = 4;
+	const size_t minors = 6;
+	const size_t dependenciesPerVersion = 3;
+	const size_t requirements = 50;
+
+	std::mt19937 random(seed);
+	Clock::time_point start = Clock::now();
+
+	HSemverResolver resolver = semver_resolver_create();
+	std::vector<HSemverVersions> arrays;
+	HSemverQuery query = semver_query_create();
+	size_t dependencyCount = 0;
+
+	for (size_t p = 0; p < packageCount; ++p)
+	{
+		std::string versions_csv;
+
+		for (size_t major = 1; major <= majors; ++major)
+			for (size_t minor = 0; minor < minors; ++minor)
+				versions_csv += (versions_csv.empty() ? "" : ", ") + std::to_string(major) + "." + std::to_string(minor) + ".0";
+
+		HSemverVersions versions = semver_versions_from_string(versions_csv.c_str(), ", ", SEMVER_ORDER_ASC);
+		arrays.push_back(versions);
+
+		std::string product = "package" + std::to_string(p);
+		semver_resolver_add_package(resolver, product.c_str(), versions);
+	}
+
+	for (size_t p = 0; p + 1 < packageCount; ++p)
+	{
+		std::string product = "package" + std::to_string(p);
+
+		for (size_t v = 0; v < majors * minors; ++v)
+		{
+			for (size_t d = 0; d < dependenciesPerVersion; ++d)
+			{
+				size_t span = std::min<size_t>(packageCount - p - 1, 200); // dependencies point down the graph, so it has no cycles
+				size_t dependency = p + 1 + random() % span;
+				std::string dependency_name = "package" + std::to_string(dependency);
+
+				size_t major = 1 + v / minors; // of the depending version, majors of an ecosystem tend to move together
+				size_t minor = v % minors;
+				size_t kind = random() % 1000;
+				std::string query_str;
+				bool lagging = (minor < minors / 2) ? kind < 50 : kind == 0; // older minors lag more often, newer ones force backtracking
+
+				if (lagging && major > 1)
+					query_str = "^" + std::to_string(major - 1) + "." + std::to_string(random() % minors);
+				else if (kind < 200)
+					query_str = ">=" + std::to_string(major) + ".0.0 <" + std::to_string(major + 1) + ".0.0";
+				else
+					query_str = "^" + std::to_string(major) + "." + std::to_string(random() % minors);
+
+				semver_query_parse(query, query_str.c_str());
+				semver_resolver_add_dependency(resolver, product.c_str(), v, dependency_name.c_str(), query);
+				++dependencyCount;
+			}
+		}
+	}
+
+	for (size_t r = 0; r < requirements && r < packageCount; ++r)
+	{
+		std::string product = "package" + std::to_string(r * packageCount / requirements);
+		semver_query_parse(query, ">=1.0.0");
+		semver_resolver_require(resolver, product.c_str(), query);
+	}
+
+	double buildMs = millisecondsSince(start);
+
+	start = Clock::now();
+	BOOL solved = semver_resolver_solve(resolver);
+	double solveMs = millisecondsSince(start);
+
+	printf("packages %6zu  versions %7zu  dependencies %8zu  build %9.2f ms  solve %9.2f ms  %s, %zu selected\n",
+		packageCount, packageCount * majors * minors, dependencyCount, buildMs, solveMs,
+		solved ? "solved" : "conflict", semver_resolver_selected_count(resolver));
+
+	semver_query_dispose(query);
+	semver_resolver_dispose(resolver);
+
+	for (HSemverVersions versions : arrays)
+		semver_versions_dispose(versions);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned seed = (argc > 2) ? static_cast<unsigned>(atoi(argv[2])) : 1;
+
+	if (argc > 1)
+	{
+		benchGraph(static_cast<size_t>(atol(argv[1])), seed);
+		return 0;
+	}
+
+	for (size_t packageCount : { 100, 1000, 5000 })
+		benchGraph(packageCount, seed);
+
+	return 0;
+}
@@ -0,0 +1,9 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "fuzz_targets.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	semver_fuzz::fuzz(semver_fuzz::Target::QUERY, data, size);
+	return 0;
+}
@@ -0,0 +1,111 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#pragma once
+#include "API/semver.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// The fuzz targets, shared by the libFuzzer entry points and the corpus tests in semver_tests. Inputs are copied
+// into strings because the API takes \0 terminated text. Broken invariants abort, so the fuzzer keeps the input
+namespace semver_fuzz
+{
+	enum class Target
+	{
+		VERSION, // a version string
+		QUERY, // a query string
+		COMPARE, // two version strings, separated by the first newline
+	};
+
+	inline void check(bool condition)
+	{
+		if (!condition)
+			abort();
+	}
+
+	// valid versions format to text that parses to an equal version
+	inline void fuzzVersion(const std::string& text)
+	{
+		HSemverVersion version = semver_version_create();
+
+		if (semver_version_parse(version, text.c_str()) == SEMVER_PARSE_SUCCESS)
+		{
+			char* formatted = semver_get_version_string(version);
+			HSemverVersion reparsed = semver_version_create();
+
+			check(semver_version_parse(reparsed, formatted) == SEMVER_PARSE_SUCCESS);
+			check(semver_compare(version, reparsed) == 0);
+			check(strcmp(semver_get_version_build(version), semver_get_version_build(reparsed)) == 0);
+
+			semver_version_dispose(reparsed);
+			semver_free_string(formatted);
+		}
+
+		semver_version_dispose(version);
+	}
+
+	// valid queries format to text that parses, and formats back to the same text
+	inline void fuzzQuery(const std::string& text)
+	{
+		HSemverQuery query = semver_query_create();
+
+		if (semver_query_parse(query, text.c_str()) == SEMVER_QUERY_PARSE_SUCCESS)
+		{
+			char* formatted = const_cast<char*>(semver_get_query_string(query));
+			HSemverQuery reparsed = semver_query_create();
+
+			check(semver_query_parse(reparsed, formatted) == SEMVER_QUERY_PARSE_SUCCESS);
+
+			char* reformatted = const_cast<char*>(semver_get_query_string(reparsed));
+			check(strcmp(formatted, reformatted) == 0);
+
+			semver_free_string(reformatted);
+			semver_query_dispose(reparsed);
+			semver_free_string(formatted);
+		}
+
+		semver_query_dispose(query);
+	}
+
+	// precedence is a total order: reflexive and antisymmetric
+	inline void fuzzCompare(const std::string& text)
+	{
+		size_t newline = text.find('\n');
+		std::string lhsText = text.substr(0, newline);
+		std::string rhsText = (newline == std::string::npos) ? std::string() : text.substr(newline + 1);
+
+		HSemverVersion lhs = semver_version_create();
+		HSemverVersion rhs = semver_version_create();
+
+		if (semver_version_parse(lhs, lhsText.c_str()) == SEMVER_PARSE_SUCCESS &&
+			semver_version_parse(rhs, rhsText.c_str()) == SEMVER_PARSE_SUCCESS)
+		{
+			int comparison = semver_compare(lhs, rhs);
+			check(semver_compare(lhs, lhs) == 0);
+			check((comparison < 0) == (semver_compare(rhs, lhs) > 0));
+			check((comparison == 0) == (semver_compare(rhs, lhs) == 0));
+		}
+
+		semver_version_dispose(lhs);
+		semver_version_dispose(rhs);
+	}
+
+	inline void fuzz(Target target, const uint8_t* data, size_t size)
+	{
+		std::string text(reinterpret_cast<const char*>(data), size);
+
+		switch (target)
+		{
+		case Target::VERSION:
+			fuzzVersion(text);
+			break;
+		case Target::QUERY:
+			fuzzQuery(text);
+			break;
+		case Target::COMPARE:
+			fuzzCompare(text);
+			break;
+		}
+	}
+}
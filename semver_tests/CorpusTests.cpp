@@ -0,0 +1,118 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "API/semver.h"
+#include "fuzz_targets.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Every input is run through the fuzz targets and has to finish within the budget. The budget is far above what
+// linear work takes on these sizes, even in a debug build with sanitizers, so only super-linear behavior fails
+static constexpr std::chrono::milliseconds corpusBudget(250);
+
+template <typename Work>
+static void expectWithinBudget(Work work, const std::string& name)
+{
+	auto start = std::chrono::steady_clock::now();
+	work();
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	EXPECT_LE(elapsed.count(), corpusBudget.count()) << name;
+}
+
+static void expectWithinBudget(semver_fuzz::Target target, const std::string& input, const std::string& name)
+{
+	expectWithinBudget([&]() { semver_fuzz::fuzz(target, reinterpret_cast<const uint8_t*>(input.data()), input.size()); }, name);
+}
+
+static std::string repeat(const std::string& piece, size_t count, const std::string& separator = "")
+{
+	std::string result;
+	result.reserve((piece.size() + separator.size()) * count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (i > 0)
+			result += separator;
+
+		result += piece;
+	}
+
+	return result;
+}
+
+TEST(SemverCorpus, CorpusEntriesWithinBudget)
+{
+	struct
+	{
+		const char* directory;
+		semver_fuzz::Target target;
+	} corpora[] = {
+		{ "version", semver_fuzz::Target::VERSION },
+		{ "query", semver_fuzz::Target::QUERY },
+		{ "compare", semver_fuzz::Target::COMPARE },
+	};
+
+	size_t entries = 0;
+
+	for (const auto& corpus : corpora)
+	{
+		for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::path(SEMVER_FUZZ_CORPUS_DIR) / corpus.directory))
+		{
+			std::ifstream file(entry.path(), std::ios::binary);
+			std::string input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+			expectWithinBudget(corpus.target, input, entry.path().string());
+			++entries;
+		}
+	}
+
+	EXPECT_GT(entries, 0u);
+}
+
+TEST(SemverCorpus, PathologicalInputsWithinBudget)
+{
+	const size_t megabyte = 1 << 20;
+	std::string longIdentifier(megabyte, 'a');
+	std::string longNumber(megabyte, '9');
+	std::string longChain = repeat("alpha.1", 100000, ".");
+	std::string manyRanges = repeat("^1.2.3 - 2.0.0", 5000, " || ");
+
+	expectWithinBudget(semver_fuzz::Target::VERSION, "1.0.0-" + longIdentifier, "megabyte prerelease identifier");
+	expectWithinBudget(semver_fuzz::Target::VERSION, "1.0.0-" + longNumber, "megabyte numeric identifier");
+	expectWithinBudget(semver_fuzz::Target::VERSION, "1.0.0+" + longIdentifier, "megabyte build");
+	expectWithinBudget(semver_fuzz::Target::VERSION, longNumber + ".0.0", "megabyte major");
+	expectWithinBudget(semver_fuzz::Target::VERSION, "1.0.0-" + longChain, "long prerelease chain");
+
+	expectWithinBudget(semver_fuzz::Target::COMPARE, "1.0.0-" + longChain + ".a\n1.0.0-" + longChain + ".b", "long equal chains");
+	expectWithinBudget(semver_fuzz::Target::COMPARE, "1.0.0-" + longIdentifier + "\n1.0.0-" + longIdentifier, "long equal identifiers");
+
+	expectWithinBudget(semver_fuzz::Target::QUERY, manyRanges, "thousands of ranges");
+	expectWithinBudget(semver_fuzz::Target::QUERY, repeat("||", 100000), "thousands of empty ranges");
+	expectWithinBudget(semver_fuzz::Target::QUERY, repeat(">=1.0.0", 20000, " "), "thousands of comparators");
+	expectWithinBudget(semver_fuzz::Target::QUERY, ">=1.0.0-" + longChain + " @" + longChain, "long query prereleases");
+	expectWithinBudget(semver_fuzz::Target::QUERY, std::string(megabyte, ' ') + "1.2.3", "megabyte of whitespace");
+	expectWithinBudget(semver_fuzz::Target::QUERY, "^" + longNumber, "megabyte query identifier");
+
+	std::string distinctRanges;
+
+	for (size_t i = 0; i < 1000; ++i) // uniting them range by range took seconds
+		distinctRanges += (i > 0 ? " || ~" : "~") + std::to_string(i) + ".0.0" + (i % 3 == 0 ? "-rc" : "");
+
+	HSemverQuery query = semver_query_create();
+	ASSERT_EQ(semver_query_parse(query, distinctRanges.c_str()), SEMVER_QUERY_PARSE_SUCCESS);
+
+	expectWithinBudget([&]()
+		{
+			HSemverQuery itself = semver_query_intersect(query, query); // normalizing sorts the ranges once
+			EXPECT_TRUE(semver_query_is_subset(itself, query));
+			semver_query_dispose(itself);
+		}, "algebra on thousands of ranges");
+
+	semver_query_dispose(query);
+}
@@ -0,0 +1,65 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "literals.h"
+#include <string>
+#include <vector>
+
+using namespace semver::literals;
+
+// literals are constants, so they can be checked at compile time too
+static_assert("1.2.3"_sv.major == 1 && "1.2.3"_sv.minor == 2 && "1.2.3"_sv.patch == 3);
+static_assert(">=3.4 <4"_svq.matches("3.9.1"_sv));
+static_assert(!">=3.4 <4"_svq.matches("4.0.0"_sv));
+static_assert(!">=3.4 <4"_svq.matches("3.5.0-rc"_sv));
+static_assert("2026.1016.20261016123045"_sv.patch == 20261016123045); // eight digits at a time
+
+TEST(SemverLiterals, VersionLiteral)
+{
+	const semver::Version& version = "1.22.333-rc.1"_sv;
+
+	EXPECT_EQ(version.major, 1);
+	EXPECT_EQ(version.minor, 22);
+	EXPECT_EQ(version.patch, 333);
+	EXPECT_STREQ(version.getPrerelease(), "rc.1");
+	EXPECT_FALSE(version.hasBuild());
+	EXPECT_EQ(version.toString(), "1.22.333-rc.1");
+
+	EXPECT_EQ(&version, &"1.22.333-rc.1"_sv); // one static object per literal
+	EXPECT_LT("1.2.3-alpha"_sv, "1.2.3"_sv);
+}
+
+template <size_t N>
+static void expectMatchesLikeParsed(const semver::StaticQuery<N>& query, const char* query_str, const std::vector<semver::Version>& versions)
+{
+	semver::Query parsed;
+	ASSERT_EQ(parsed.parse(query_str, strlen(query_str)), SEMVER_QUERY_PARSE_SUCCESS);
+	EXPECT_EQ(query.size(), parsed.rangeSet.size()) << query_str;
+
+	for (const semver::Version& version : versions)
+		EXPECT_EQ(query.matches(version), parsed.matches(version)) << query_str << " at " << version.toString();
+
+	for (semver::Range& r : parsed.rangeSet)
+		r.deleteHeapResources();
+}
+
+TEST(SemverLiterals, QueryLiteralMatchesLikeParsedQuery)
+{
+	std::vector<semver::Version> versions;
+
+	for (const char* str : { "0.9.0", "1.0.0-alpha", "1.0.0", "1.2.3-beta", "1.2.3-beta.2", "1.2.3", "1.2.4-alpha", "1.2.4-rc",
+		"1.3.0", "1.9.9", "2.0.0-rc", "2.0.0", "2.1.0-rc.1", "2.1.0-beta", "3.4.0", "3.9.1", "4.0.0-0", "4.0.0" })
+	{
+		semver::Version version{ 0, 0, 0, semver::Version::MANAGED };
+		version.parse(str, strlen(str));
+		versions.push_back(version);
+	}
+
+	expectMatchesLikeParsed(">=3.4 <4"_svq, ">=3.4 <4", versions);
+	expectMatchesLikeParsed("^1.2.3-beta || 2.x @rc"_svq, "^1.2.3-beta || 2.x @rc", versions);
+	expectMatchesLikeParsed("~1.2 || >=2.0.0-rc <=2.1.0-rc.1"_svq, "~1.2 || >=2.0.0-rc <=2.1.0-rc.1", versions);
+	expectMatchesLikeParsed("1.0.0 - 1.2.4-rc @alpha"_svq, "1.0.0 - 1.2.4-rc @alpha", versions);
+	expectMatchesLikeParsed("*"_svq, "*", versions);
+	expectMatchesLikeParsed("<0.0.0-0"_svq, "<0.0.0-0", versions);
+}
@@ -3,6 +3,9 @@
 #include "pch.h"
 #include "gtest/gtest.h"
 #include "API/semver.h"
+#include <random>
+#include <string>
+#include <vector>
 
 
 TEST(SemverRange, ParseGTERange)
@@ -635,6 +638,22 @@ TEST(SemverRange, QueryVersionBlock)
 
 }
 
+// the versions of QueryASCSortedVersionBlock and a 3.x line, and queries over them. Tests add the queries they need
+static const char sBlockVersions[] =
+	"1.2.2, 1.2.4, 1.2.3-alpha, 1.3.0, 0.7.1, 0.7.2, 1.2.3, 0.7.3, 0.8.0, 0.7.2-beta, 1.2.5, 1.2.3-alpha, 0.0.0, "
+	"1.0.0, 2.0.0-alpha, 1.2.6, 999.999.999, 1.2.3-rc.1, 1.2.5-rc, 1.2.3-beta, 1.2.4-rc, 1.2.5-alpha, "
+	"1.0.0-alpha, 1.0.1, 2.0.0-alpha, 1.2.4-beta, 2.0.0, 2.0.1, 2.1.0, 1.2.5-rc, 2.1.1, 3.2.0, 3.2.9, 3.10.1";
+
+static const char* const sBlockQueries[] = { "~1.2.3", "^0.7.2", "1.2.3 - 1.2.5", "^1.2.3-alpha", ">=1.2.4-rc", "<1.0.0", "^3.2", "~1.4.0",
+	">2.1.1 <3.2.9", "^4", "<0.0.0", "*", ">=999.999.999", "^1.2.4 || ~0.7.2 @beta", "^2.0.0-alpha @alpha" };
+
+static std::vector<const char*> blockQueries(std::initializer_list<const char*> extra) // sBlockQueries, then extra
+{
+	std::vector<const char*> queries(std::begin(sBlockQueries), std::end(sBlockQueries));
+	queries.insert(queries.end(), extra);
+	return queries;
+}
+
 TEST(SemverRange, QueryASCSortedVersionBlock)
 {
 
@@ -754,4 +773,873 @@ TEST(SemverRange, QueryASCSortedVersionBlock)
 
 
 	semver_versions_dispose(versions);
-}
\ No newline at end of file
+}
+TEST(SemverRange, FormatQueryString)
+{
+	const char* queries[] =
+	{
+		">=1.2.3-alpha",
+		">2.1",
+		"<5.1.3 >5.1.3",
+		"~1.2.3",
+		"1.2.3 - 4.5.6",
+		"1.2.3||>=2.3.4 <2.3.6",
+		"> 3.2.1 <= 4.5.2 @beta",
+		"* @rc",
+	};
+
+	HSemverQuery query = semver_query_create();
+	char buf[64];
+
+	for (const char* q : queries)
+	{
+		semver_query_parse(query, q);
+
+		const char* expected = semver_get_query_string(query);
+		size_t len = semver_query_format(query, buf, sizeof(buf));
+
+		EXPECT_EQ(len, strlen(expected));
+		EXPECT_STREQ(buf, expected);
+		EXPECT_EQ(semver_query_format(query, nullptr, 0), len);
+
+		semver_free_string(const_cast<char*>(expected));
+	}
+
+	semver_query_dispose(query);
+}
+
+TEST(SemverRange, QueryGrowableVersionBlock)
+{
+	HSemverVersions versions = semver_versions_create_growable(0, SEMVER_ORDER_ASC);
+
+	const char* initial[] = { "1.2.4", "1.2.3", "2.0.0", "1.2.3-beta", "1.3.0", "1.2.5+build.7" };
+
+	for (const char* v : initial)
+		EXPECT_NE(semver_versions_append(versions, v), nullptr);
+
+	HSemverQuery query = semver_query_create();
+	semver_query_parse(query, "~1.2.3");
+
+	HSemverVersions results = semver_query_match_versions(query, versions);
+	ASSERT_EQ(semver_versions_count(results), 3);
+
+	for (int i = 0; i < 1000; ++i) // many new chunks, references must survive
+	{
+		std::string version = "3." + std::to_string(999 - i) + ".0";
+		semver_versions_append(versions, version.c_str());
+	}
+
+	semver_versions_append(versions, "1.2.6");
+
+	const char* matches[3] = { "1.2.3", "1.2.4", "1.2.5+build.7" };
+
+	for (size_t i = 0; i < 3; ++i)
+	{
+		char* readstr = semver_get_version_string(semver_versions_get_version_at_index(results, i));
+		EXPECT_STREQ(matches[i], readstr);
+		semver_free_string(readstr);
+	}
+
+	size_t count = semver_versions_count(versions);
+	ASSERT_EQ(count, 1007);
+
+	for (size_t i = 1; i < count; ++i) // binary insertion kept the block sorted
+		EXPECT_TRUE(semver_version_is_less_or_equal(semver_versions_get_version_at_index(versions, i - 1), semver_versions_get_version_at_index(versions, i)));
+
+	results = semver_query_match_versions(query, versions);
+	EXPECT_EQ(semver_versions_count(results), 4);
+
+	HSemverVersions fixed = semver_versions_from_string("1.0.0", ", ", SEMVER_ORDER_ASC);
+	EXPECT_EQ(semver_versions_append(fixed, "2.0.0"), nullptr); // only growable blocks can be appended to
+	semver_versions_dispose(fixed);
+
+	semver_versions_dispose(versions);
+	semver_query_dispose(query);
+}
+
+TEST(SemverRange, QueryResultsDisposedInAnyOrder)
+{
+	std::string versions_str;
+
+	for (int major = 0; major < 4; ++major)
+		for (int minor = 0; minor < 300; ++minor)
+			versions_str += std::to_string(major) + "." + std::to_string(minor) + ".0,";
+
+	versions_str.pop_back();
+
+	HSemverVersions versions = semver_versions_from_string(versions_str.c_str(), ",", SEMVER_ORDER_ASC);
+
+	const char* queries[] = { "~1.2", "^1.2.0 <1.10.0", "^2", "1.0.0 - 1.299.0 || 3.0.0 - 3.299.0", "^3.1 <3.7", "*" };
+	const size_t counts[] = { 1, 8, 300, 600, 6, 1200 }; // pooled classes and beyond
+
+	HSemverQuery query = semver_query_create();
+
+	auto expectFirst = [](HSemverVersions results, const char* expected)
+		{
+			char* first = semver_get_version_string(semver_versions_get_version_at_index(results, 0));
+			EXPECT_STREQ(first, expected);
+			semver_free_string(first);
+		};
+
+	for (int round = 0; round < 3; ++round) // later rounds reuse disposed blocks
+	{
+		std::vector<HSemverVersions> results;
+
+		for (const char* query_str : queries)
+		{
+			semver_query_parse(query, query_str);
+			results.push_back(semver_query_match_versions(query, versions));
+		}
+
+		for (size_t i = 0; i < results.size(); ++i)
+			EXPECT_EQ(semver_versions_count(results[i]), counts[i]) << queries[i];
+
+		semver_versions_dispose(results[3]); // early, from the middle, the last and the first of the owner's list
+		semver_versions_dispose(results[5]);
+		semver_versions_dispose(results[0]);
+
+		expectFirst(results[1], "1.2.0");
+		expectFirst(results[2], "2.0.0");
+		expectFirst(results[4], "3.1.0");
+
+		if (round == 2) // the rest goes with the owner
+			break;
+
+		semver_versions_dispose(results[1]);
+		semver_versions_dispose(results[2]);
+		semver_versions_dispose(results[4]);
+	}
+
+	semver_versions_dispose(versions);
+	semver_query_dispose(query);
+}
+
+TEST(SemverRange, QueryVersionBlockWithLimit)
+{
+	std::vector<const char*> queries = blockQueries({ "^3 || ^0.7 || ~1.2.4 || >=1.2.5 <2", "^1 || ~1.2 || 1.2.3 - 1.2.4" });
+
+	auto strings = [](std::vector<HSemverVersion> versions)
+		{
+			std::vector<std::string> strs;
+
+			for (HSemverVersion version : versions)
+			{
+				char* str = semver_get_version_string(version);
+				strs.push_back(str);
+				semver_free_string(str);
+			}
+
+			return strs;
+		};
+
+	auto handles = [](HSemverVersions versions)
+		{
+			std::vector<HSemverVersion> result;
+
+			for (size_t i = 0; i < semver_versions_count(versions); ++i)
+				result.push_back(semver_versions_get_version_at_index(versions, i));
+
+			return result;
+		};
+
+	HSemverQuery query = semver_query_create();
+
+	for (SemverOrder blockOrder : { SEMVER_ORDER_AS_GIVEN, SEMVER_ORDER_ASC, SEMVER_ORDER_DESC })
+	{
+		for (bool indexed : { false, true })
+		{
+			HSemverVersions versions = semver_versions_from_string(sBlockVersions, ", ", blockOrder);
+
+			if (indexed && !semver_versions_index(versions))
+			{
+				semver_versions_dispose(versions);
+				continue; // unsorted
+			}
+
+			for (const char* query_str : queries)
+			{
+				semver_query_parse(query, query_str);
+				HSemverVersions all = semver_query_match_versions(query, versions);
+
+				for (SemverOrder order : { SEMVER_ORDER_AS_GIVEN, SEMVER_ORDER_ASC, SEMVER_ORDER_DESC })
+				{
+					std::vector<HSemverVersion> expected = handles(all);
+
+					if (order != SEMVER_ORDER_AS_GIVEN)
+						std::stable_sort(expected.begin(), expected.end(), [order](HSemverVersion x, HSemverVersion y)
+							{ return semver_compare(x, y) * (order == SEMVER_ORDER_ASC ? 1 : -1) < 0; });
+
+					for (size_t offset : { 0, 1, 3, 100 })
+					{
+						for (size_t limit : { (size_t)0, (size_t)1, (size_t)2, (size_t)5, SIZE_MAX })
+						{
+							size_t first = std::min(offset, expected.size());
+							size_t last = first + std::min(limit, expected.size() - first);
+
+							HSemverVersions limited = semver_query_match_versions_limit(query, versions, offset, limit, order);
+							EXPECT_EQ(strings(handles(limited)), strings({ expected.begin() + first, expected.begin() + last }))
+								<< query_str << " offset " << offset << " limit " << limit << " order " << order << " of " << blockOrder;
+							semver_versions_dispose(limited);
+						}
+					}
+				}
+
+				semver_versions_dispose(all);
+			}
+
+			semver_versions_dispose(versions);
+		}
+	}
+
+	semver_query_dispose(query);
+}
+
+TEST(SemverRange, MatchCursorWalksMatches)
+{
+	std::vector<const char*> queries = blockQueries({ "^3 || ^0.7 || ~1.2.4 || >=1.2.5 <2", "^1 || ~1.2 || 1.2.3 - 1.2.4", "^1.2 || ^0.7 || ^1.2.4" });
+
+	HSemverQuery query = semver_query_create();
+
+	for (SemverOrder blockOrder : { SEMVER_ORDER_AS_GIVEN, SEMVER_ORDER_ASC, SEMVER_ORDER_DESC })
+	{
+		for (bool indexed : { false, true })
+		{
+			HSemverVersions versions = semver_versions_from_string(sBlockVersions, ", ", blockOrder);
+
+			if (indexed && !semver_versions_index(versions))
+			{
+				semver_versions_dispose(versions);
+				continue; // unsorted
+			}
+
+			for (const char* query_str : queries)
+			{
+				semver_query_parse(query, query_str);
+				HSemverVersions all = semver_query_match_versions(query, versions);
+
+				std::vector<HSemverVersion> expected;
+
+				for (size_t i = 0; i < semver_versions_count(all); ++i)
+					expected.push_back(semver_versions_get_version_at_index(all, i));
+
+				SemverMatchCursor cursor;
+				semver_match_cursor_init(&cursor, query, versions);
+
+				std::vector<HSemverVersion> walked;
+
+				while (HSemverVersion version = semver_match_cursor_next(&cursor))
+					walked.push_back(version);
+
+				EXPECT_EQ(walked, expected) << query_str << " of " << blockOrder << (indexed ? " indexed" : "");
+				EXPECT_EQ(semver_match_cursor_next(&cursor), nullptr); // stays at the end
+
+				semver_versions_dispose(all);
+			}
+
+			semver_versions_dispose(versions);
+		}
+	}
+
+	semver_query_dispose(query);
+}
+
+TEST(SemverRange, QueryIndexedVersionBlock)
+{
+	std::vector<const char*> queries = blockQueries({});
+
+	auto resultStrings = [](HSemverQuery query, HSemverVersions versions)
+		{
+			HSemverVersions results = semver_query_match_versions(query, versions);
+			std::vector<std::string> strs;
+
+			for (size_t i = 0; i < semver_versions_count(results); ++i)
+			{
+				char* str = semver_get_version_string(semver_versions_get_version_at_index(results, i));
+				strs.push_back(str);
+				semver_free_string(str);
+			}
+
+			semver_versions_dispose(results);
+			return strs;
+		};
+
+	HSemverQuery query = semver_query_create();
+
+	for (SemverOrder order : { SEMVER_ORDER_ASC, SEMVER_ORDER_DESC })
+	{
+		HSemverVersions plain = semver_versions_from_string(sBlockVersions, ", ", order);
+		HSemverVersions indexed = semver_versions_from_string(sBlockVersions, ", ", order);
+		EXPECT_TRUE(semver_versions_index(indexed));
+
+		for (const char* query_str : queries)
+		{
+			semver_query_parse(query, query_str);
+			EXPECT_EQ(resultStrings(query, indexed), resultStrings(query, plain)) << query_str;
+		}
+
+		semver_versions_dispose(indexed);
+		semver_versions_dispose(plain);
+	}
+
+	HSemverVersions unsorted = semver_versions_from_string(sBlockVersions, ", ", SEMVER_ORDER_AS_GIVEN);
+	EXPECT_FALSE(semver_versions_index(unsorted));
+	semver_versions_dispose(unsorted);
+
+	HSemverVersions growable = semver_versions_create_growable(0, SEMVER_ORDER_DESC);
+	EXPECT_FALSE(semver_versions_index(growable)); // empty
+	semver_versions_append(growable, "1.2.3");
+	EXPECT_TRUE(semver_versions_index(growable));
+	semver_versions_append(growable, "1.2.4"); // drops the index, which no longer knows where 1.2.x starts
+
+	semver_query_parse(query, "~1.2.3");
+	std::vector<std::string> matches = { "1.2.4", "1.2.3" };
+	EXPECT_EQ(resultStrings(query, growable), matches);
+
+	semver_versions_dispose(growable);
+	semver_query_dispose(query);
+}
+
+TEST(SemverRange, QueriesMatchVersionBlock)
+{
+	std::vector<const char*> query_strs = blockQueries({ ">1.2.3-alpha <=1.2.5-rc" });
+
+	const size_t queryCount = query_strs.size();
+	std::vector<HSemverQuery> queries(queryCount);
+
+	for (size_t q = 0; q < queryCount; ++q)
+	{
+		queries[q] = semver_query_create();
+		ASSERT_EQ(semver_query_parse(queries[q], query_strs[q]), SEMVER_QUERY_PARSE_SUCCESS) << query_strs[q];
+	}
+
+	for (SemverOrder order : { SEMVER_ORDER_AS_GIVEN, SEMVER_ORDER_ASC, SEMVER_ORDER_DESC })
+	{
+		HSemverVersions versions = semver_versions_from_string(sBlockVersions, ", ", order);
+		size_t count = semver_versions_count(versions);
+		size_t words = SEMVER_MATCH_BITS_WORDS(count);
+
+		std::vector<uint64_t> bits(words * queryCount, ~0ull); // all overwritten
+		semver_queries_match_versions(queries.data(), queryCount, versions, bits.data());
+
+		for (size_t q = 0; q < queryCount; ++q)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				bool expected = semver_query_matches_version(queries[q], semver_versions_get_version_at_index(versions, i));
+				bool actual = (bits[q * words + i / 64] >> (i % 64)) & 1;
+				EXPECT_EQ(actual, expected) << query_strs[q] << " at " << i << " order " << order;
+			}
+
+			for (size_t i = count; i < words * 64; ++i)
+				EXPECT_FALSE((bits[q * words + i / 64] >> (i % 64)) & 1);
+		}
+
+		semver_versions_dispose(versions);
+	}
+
+	HSemverVersions many = semver_versions_create_growable(0, SEMVER_ORDER_ASC); // spans several words
+
+	for (int i = 0; i < 300; ++i)
+	{
+		std::string version = "1." + std::to_string(i / 10) + "." + std::to_string(i % 10) + ((i % 7 == 0) ? "-rc" : "");
+		semver_versions_append(many, version.c_str());
+	}
+
+	semver_query_parse(queries[0], ">=1.3.5 <1.25.0-0 @rc");
+	semver_query_parse(queries[1], "1.0.0 - 1.29.9");
+
+	std::vector<uint64_t> bits(SEMVER_MATCH_BITS_WORDS(300) * 2);
+	semver_queries_match_versions(queries.data(), 2, many, bits.data());
+
+	for (size_t q = 0; q < 2; ++q)
+		for (size_t i = 0; i < 300; ++i)
+			EXPECT_EQ((bits[q * SEMVER_MATCH_BITS_WORDS(300) + i / 64] >> (i % 64)) & 1,
+				semver_query_matches_version(queries[q], semver_versions_get_version_at_index(many, i)) ? 1u : 0u) << q << " at " << i;
+
+	semver_versions_dispose(many);
+
+	for (HSemverQuery query : queries)
+		semver_query_dispose(query);
+}
+
+TEST(SemverRange, QueryIndexMatchesVersion)
+{
+	std::vector<const char*> query_strs = blockQueries({ ">1.2.3-alpha <=1.2.5-rc", "1.2.x || 1.3.x || 2.0.0 - 2.1.0",
+		"=1.2.3-rc.1", ">=1.2.3 <1.2.3", "^1.2.3-a.very.long.prerelease.on.the.heap" });
+
+	const size_t queryCount = query_strs.size();
+	std::vector<HSemverQuery> queries(queryCount);
+	HSemverQueryIndex index = semver_query_index_create();
+
+	for (size_t q = 0; q < queryCount; ++q)
+	{
+		queries[q] = semver_query_create();
+		ASSERT_EQ(semver_query_parse(queries[q], query_strs[q]), SEMVER_QUERY_PARSE_SUCCESS) << query_strs[q];
+		semver_query_index_add(index, queries[q], q + 100);
+	}
+
+	std::string versions_str = std::string(sBlockVersions) + ", 0.0.0-0, 1.2.3-a.very.long.prerelease.on.the.heap.z, 4.0.0, 1.4.0, 1.4.9, 1.5.0-0";
+	HSemverVersions versions = semver_versions_from_string(versions_str.c_str(), ", ", SEMVER_ORDER_AS_GIVEN);
+
+	auto check = [&](const std::vector<bool>& indexed)
+		{
+			std::vector<uint64_t> ids(queryCount);
+
+			for (size_t i = 0; i < semver_versions_count(versions); ++i)
+			{
+				HSemverVersion version = semver_versions_get_version_at_index(versions, i);
+
+				std::vector<uint64_t> expected;
+				for (size_t q = 0; q < queryCount; ++q)
+					if (indexed[q] && semver_query_matches_version(queries[q], version))
+						expected.push_back(q + 100);
+
+				size_t count = semver_query_index_match(index, version, ids.data(), queryCount);
+				EXPECT_EQ(std::vector<uint64_t>(ids.begin(), ids.begin() + count), expected) << "at " << i;
+			}
+		};
+
+	std::vector<bool> indexed(queryCount, true);
+	check(indexed);
+
+	for (size_t q = 0; q < queryCount; q += 3)
+	{
+		EXPECT_TRUE(semver_query_index_remove(index, q + 100));
+		indexed[q] = false;
+	}
+
+	EXPECT_FALSE(semver_query_index_remove(index, 100)); // already removed
+	check(indexed);
+
+	for (HSemverQuery query : queries)
+		semver_query_dispose(query); // the index has its own copies
+
+	HSemverVersion version = semver_version_create();
+	semver_version_parse(version, "1.2.4");
+	uint64_t first[2];
+	EXPECT_EQ(semver_query_index_match(index, version, first, 2), 6); // "1.2.3 - 1.2.5", ">=1.2.4-rc", "*", "^1.2.4 || ...", "1.2.x || ...", "^1.2.3-a.very..."
+	EXPECT_EQ(first[0], 102);
+	EXPECT_EQ(first[1], 104);
+
+	semver_version_dispose(version);
+	semver_versions_dispose(versions);
+	semver_query_index_dispose(index);
+}
+
+TEST(SemverRange, QueryWatchKeepsHighestMatch)
+{
+	std::vector<const char*> query_strs = blockQueries({ ">=1.2.3 <1.2.3", "^1.2.3-a.very.long.prerelease.on.the.heap" });
+
+	const size_t queryCount = query_strs.size();
+	std::vector<HSemverQuery> queries(queryCount);
+	HSemverQueryWatch watch = semver_query_watch_create();
+
+	for (size_t q = 0; q < queryCount; ++q)
+	{
+		queries[q] = semver_query_create();
+		ASSERT_EQ(semver_query_parse(queries[q], query_strs[q]), SEMVER_QUERY_PARSE_SUCCESS) << query_strs[q];
+		semver_query_watch_add(watch, queries[q], q + 100);
+	}
+
+	std::string versions_str = "1.2.5+build.1, 1.2.5+build.2, 0.0.0-0, 1.2.3-a.very.long.prerelease.on.the.heap.z, 4.0.0, 1.4.0, 0.7.9, " + std::string(sBlockVersions);
+	HSemverVersions versions = semver_versions_from_string(versions_str.c_str(), ", ", SEMVER_ORDER_AS_GIVEN);
+	std::vector<HSemverVersion> expected(queryCount, nullptr); // highest match of the versions pushed so far
+	std::vector<uint64_t> ids(queryCount);
+
+	for (size_t i = 0; i < semver_versions_count(versions); ++i)
+	{
+		HSemverVersion version = semver_versions_get_version_at_index(versions, i);
+		std::vector<uint64_t> changed;
+
+		for (size_t q = 0; q < queryCount; ++q)
+		{
+			if (semver_query_matches_version(queries[q], version) && (!expected[q] || semver_compare(version, expected[q]) > 0))
+			{
+				expected[q] = version;
+				changed.push_back(q + 100);
+			}
+		}
+
+		size_t count = semver_query_watch_push(watch, version, ids.data(), queryCount);
+		EXPECT_EQ(std::vector<uint64_t>(ids.begin(), ids.begin() + count), changed) << "at " << i;
+
+		for (size_t q = 0; q < queryCount; ++q)
+		{
+			HSemverVersion best = semver_query_watch_best(watch, q + 100);
+			ASSERT_EQ(best == nullptr, expected[q] == nullptr) << query_strs[q] << " at " << i;
+
+			if (best)
+			{
+				EXPECT_EQ(semver_compare(best, expected[q]), 0) << query_strs[q] << " at " << i;
+			}
+		}
+	}
+
+	HSemverVersion best = semver_query_watch_best(watch, 102); // 1.2.3 - 1.2.5
+	EXPECT_STREQ(semver_get_version_build(best), "build.1"); // the same version again is not a change
+	semver_version_dispose(best); // owned by the watch, does nothing
+	EXPECT_EQ(semver_query_watch_best(watch, 110), nullptr); // <0.0.0 matches nothing
+
+	for (HSemverQuery query : queries)
+		semver_query_dispose(query); // the watch has its own copies
+
+	EXPECT_TRUE(semver_query_watch_remove(watch, 111)); // *
+	EXPECT_FALSE(semver_query_watch_remove(watch, 111));
+	EXPECT_EQ(semver_query_watch_best(watch, 111), nullptr);
+
+	HSemverQuery query = semver_query_create();
+	semver_query_parse(query, "^5");
+	semver_query_watch_add(watch, query, 106); // shares the best match of ^3.2
+	semver_query_dispose(query);
+
+	HSemverVersion version = semver_version_create();
+	semver_version_parse(version, "3.11.0");
+	EXPECT_EQ(semver_query_watch_push(watch, version, ids.data(), queryCount), 1u);
+	EXPECT_EQ(ids[0], 106u);
+
+	semver_version_parse(version, "5.1.0");
+	EXPECT_EQ(semver_query_watch_push(watch, version, ids.data(), 0), 1u); // ^5, >=1.2.4-rc keeps 999.999.999
+	semver_version_parse(version, "3.12.0"); // below the best of 106, although ^3.2 matches it
+	EXPECT_EQ(semver_query_watch_push(watch, version, ids.data(), queryCount), 0u);
+	EXPECT_EQ(semver_get_version_major(semver_query_watch_best(watch, 106)), 5u);
+
+	semver_version_dispose(version);
+	semver_versions_dispose(versions);
+	semver_query_watch_dispose(watch);
+}
+
+static std::string queryString(HSemverQuery query)
+{
+	std::string str(semver_query_format(query, nullptr, 0), '\0');
+	semver_query_format(query, str.data(), str.size() + 1);
+	return str;
+}
+
+TEST(SemverRange, QueryAlgebra)
+{
+	HSemverQuery lhs = semver_query_create();
+	HSemverQuery rhs = semver_query_create();
+
+	auto parse = [&](const char* lhs_str, const char* rhs_str)
+		{
+			ASSERT_EQ(semver_query_parse(lhs, lhs_str), SEMVER_QUERY_PARSE_SUCCESS);
+			ASSERT_EQ(semver_query_parse(rhs, rhs_str), SEMVER_QUERY_PARSE_SUCCESS);
+		};
+
+	auto expectQuery = [](HSemverQuery query, const char* expected)
+		{
+			EXPECT_EQ(queryString(query), expected);
+			semver_query_dispose(query);
+		};
+
+	parse(">=1.5 <2.1", "^1.2 || ^2");
+	EXPECT_TRUE(semver_query_is_subset(lhs, rhs));
+	EXPECT_FALSE(semver_query_is_subset(rhs, lhs));
+	EXPECT_FALSE(semver_query_is_disjoint(lhs, rhs));
+	expectQuery(semver_query_intersect(lhs, rhs), ">=1.5.0 <2.1.0");
+	expectQuery(semver_query_union(lhs, rhs), ">=1.2.0 <3.0.0");
+	expectQuery(semver_query_complement(rhs), "<1.2.0 || >=3.0.0");
+
+	parse("^1.2.3", "~1.4 || >=2.0.0");
+	expectQuery(semver_query_intersect(lhs, rhs), ">=1.4.0 <1.5.0");
+	expectQuery(semver_query_union(lhs, rhs), ">=1.2.3");
+	EXPECT_FALSE(semver_query_is_subset(lhs, rhs));
+
+	parse("<1.0.0", ">=1.0.0");
+	EXPECT_TRUE(semver_query_is_disjoint(lhs, rhs));
+	expectQuery(semver_query_intersect(lhs, rhs), "<0.0.0-0"); // matches nothing
+	expectQuery(semver_query_union(lhs, rhs), "x");
+	expectQuery(semver_query_complement(lhs), ">=1.0.0");
+
+	// prerelease bounds admit the prereleases of their own core, and only those
+	parse("^1.2.3-beta", ">=1.2.3-rc <1.3.0");
+	EXPECT_TRUE(semver_query_is_subset(rhs, lhs));
+	EXPECT_FALSE(semver_query_is_subset(lhs, rhs));
+	expectQuery(semver_query_intersect(lhs, rhs), ">=1.2.3-rc <1.3.0");
+	expectQuery(semver_query_complement(lhs), "<1.2.3 || >=2.0.0");
+
+	parse("<1.2.3-beta", ">=1.2.3-alpha <1.2.4");
+	expectQuery(semver_query_intersect(lhs, rhs), ">=1.2.3-alpha <1.2.3-beta");
+	EXPECT_FALSE(semver_query_is_disjoint(lhs, rhs));
+
+	// a minimum prerelease admits prereleases of every core within the bounds
+	parse(">=1.0.0 <2.0.0 @beta", ">=1.2.3-rc <1.2.3");
+	EXPECT_TRUE(semver_query_is_subset(rhs, lhs)); // rc >= beta
+	parse(">=1.0.0 <2.0.0 @rc", ">=1.2.3-beta <1.2.3");
+	EXPECT_FALSE(semver_query_is_subset(rhs, lhs));
+	expectQuery(semver_query_intersect(lhs, rhs), ">=1.2.3-rc <1.2.3");
+
+	parse("^1.0.0 @beta", "^1.0.0 @rc");
+	EXPECT_TRUE(semver_query_is_subset(rhs, lhs));
+	EXPECT_FALSE(semver_query_is_subset(lhs, rhs));
+	expectQuery(semver_query_intersect(lhs, rhs), ">=1.0.0 <2.0.0-0 @rc");
+	expectQuery(semver_query_union(lhs, rhs), ">=1.0.0 <2.0.0-0 @beta");
+
+	parse(">1.2.3 @alpha", "<1.2.4");
+	EXPECT_TRUE(semver_query_is_disjoint(lhs, rhs)); // rhs does not opt in to 1.2.4-alpha
+	parse(">1.2.3 @alpha", "<1.2.4 @beta");
+	EXPECT_FALSE(semver_query_is_disjoint(lhs, rhs));
+	expectQuery(semver_query_intersect(lhs, rhs), ">=1.2.4-beta <1.2.4");
+
+	// a lower bound of 0.0.0-0 that opts in keeps the prereleases of 0.0.0, unlike the open lower bound of x
+	parse("0.x", ">=0.0.0-0 || 3.1.0 - 2.1.2");
+	expectQuery(semver_query_union(lhs, rhs), ">=0.0.0-0");
+	parse(">=0.0.0-0 <2.1.2", "*");
+	expectQuery(semver_query_union(lhs, rhs), ">=0.0.0-0");
+	parse("<3.2.1", "<0.0.0 @0 || ^0.2.1 || <2.2.0");
+	expectQuery(semver_query_union(lhs, rhs), ">=0.0.0-0 <3.2.1");
+
+	HSemverVersion prerelease = semver_version_create_defined(0, 0, 0, "alpha", "");
+	HSemverQuery united = semver_query_union(lhs, rhs);
+	EXPECT_TRUE(semver_query_matches_version(united, prerelease));
+	semver_query_dispose(united);
+	semver_version_dispose(prerelease);
+
+	semver_query_dispose(lhs);
+	semver_query_dispose(rhs);
+}
+
+TEST(SemverRange, QueryAlgebraAgreesWithMatching)
+{
+	// prereleases include the directly following ones (x.0) the bounds of random queries can lead to
+	const char* tags[] = { "", "0", "0.0", "alpha", "alpha.0", "beta", "beta.0", "rc", "rc.0", "rc.1", "rc.1.0", "rc.2" };
+	const char* query_tags[] = { "alpha", "beta", "rc", "rc.1" };
+	const char* comparators[] = { "^", "~", ">=", ">", "<", "<=", "", "=" };
+
+	std::vector<HSemverVersion> versions;
+	std::vector<bool> isPrerelease;
+
+	for (uint64_t major = 0; major < 4; ++major) // queries use 0 to 2, 3 samples the versions above their bounds
+		for (uint64_t minor = 0; minor < 4; ++minor)
+			for (uint64_t patch = 0; patch < 4; ++patch)
+				for (const char* tag : tags)
+				{
+					versions.push_back(semver_version_create_defined(major, minor, patch, tag, ""));
+					isPrerelease.push_back(*tag != '\0');
+				}
+
+	std::mt19937 random(7);
+
+	auto randomVersion = [&](bool withPrerelease)
+		{
+			std::string str = std::to_string(random() % 3) + "." + std::to_string(random() % 3) + "." + std::to_string(random() % 3);
+
+			if (withPrerelease && random() % 3 == 0)
+				str += std::string("-") + query_tags[random() % 4];
+
+			return str;
+		};
+
+	auto randomQuery = [&]()
+		{
+			std::string str;
+
+			for (size_t r = 0, count = 1 + random() % 2; r < count; ++r)
+			{
+				if (r > 0)
+					str += " || ";
+
+				switch (random() % 4)
+				{
+				case 0:
+					str += randomVersion(true) + " - " + randomVersion(true);
+					break;
+
+				case 1:
+					str += std::to_string(random() % 3) + ".x";
+					break;
+
+				default:
+					str += comparators[random() % 8] + randomVersion(true);
+
+					if (random() % 2)
+						str += std::string(" ") + comparators[2 + random() % 4] + randomVersion(true);
+				}
+
+				if (random() % 3 == 0)
+					str += std::string(" @") + query_tags[random() % 4];
+			}
+
+			return str;
+		};
+
+	HSemverQuery lhs = semver_query_create();
+	HSemverQuery rhs = semver_query_create();
+	HSemverQuery reparsed = semver_query_create();
+
+	for (int round = 0; round < 1000; ++round)
+	{
+		std::string lhs_str = randomQuery();
+		std::string rhs_str = randomQuery();
+		ASSERT_EQ(semver_query_parse(lhs, lhs_str.c_str()), SEMVER_QUERY_PARSE_SUCCESS) << lhs_str;
+		ASSERT_EQ(semver_query_parse(rhs, rhs_str.c_str()), SEMVER_QUERY_PARSE_SUCCESS) << rhs_str;
+
+		HSemverQuery intersection = semver_query_intersect(lhs, rhs);
+		HSemverQuery both = semver_query_union(lhs, rhs);
+		HSemverQuery complement = semver_query_complement(lhs);
+
+		bool subset = true;
+		bool disjoint = true;
+
+		for (HSemverQuery result : { intersection, both, complement }) // results parse back to the same versions
+		{
+			std::string result_str = queryString(result);
+			ASSERT_EQ(semver_query_parse(reparsed, result_str.c_str()), SEMVER_QUERY_PARSE_SUCCESS) << result_str;
+
+			for (HSemverVersion version : versions)
+				ASSERT_EQ(semver_query_matches_version(reparsed, version), semver_query_matches_version(result, version)) << result_str;
+		}
+
+		for (size_t i = 0; i < versions.size(); ++i)
+		{
+			bool l = semver_query_matches_version(lhs, versions[i]);
+			bool r = semver_query_matches_version(rhs, versions[i]);
+			auto context = [&]() // only built when an expectation fails
+				{
+					char* version_str = semver_get_version_string(versions[i]);
+					std::string at = lhs_str + " and " + rhs_str + " at " + version_str;
+					semver_free_string(version_str);
+					return at;
+				};
+
+			EXPECT_EQ(semver_query_matches_version(intersection, versions[i]), l && r) << context();
+			EXPECT_EQ(semver_query_matches_version(both, versions[i]), l || r) << context();
+			EXPECT_EQ(semver_query_matches_version(complement, versions[i]), !l && !isPrerelease[i]) << context();
+
+			subset = subset && (!l || r);
+			disjoint = disjoint && !(l && r);
+		}
+
+		EXPECT_EQ(semver_query_is_subset(lhs, rhs), subset) << lhs_str << " in " << rhs_str;
+		EXPECT_EQ(semver_query_is_disjoint(lhs, rhs), disjoint) << lhs_str << " and " << rhs_str;
+
+		semver_query_dispose(intersection);
+		semver_query_dispose(both);
+		semver_query_dispose(complement);
+	}
+
+	for (HSemverVersion version : versions)
+		semver_version_dispose(version);
+
+	semver_query_dispose(lhs);
+	semver_query_dispose(rhs);
+	semver_query_dispose(reparsed);
+}
+
+TEST(SemverRange, StableOnlyQueryEditedThroughHandles)
+{
+	HSemverQuery query = semver_query_create();
+	HSemverVersion beta = semver_version_create_defined(1, 5, 0, "beta", "");
+	HSemverVersion stable = semver_version_create_defined(1, 5, 0, "", "");
+
+	ASSERT_EQ(semver_query_parse(query, "^1.2.3 || ~2.0"), SEMVER_QUERY_PARSE_SUCCESS); // matched without prerelease handling
+	EXPECT_TRUE(semver_query_matches_version(query, stable));
+	EXPECT_FALSE(semver_query_matches_version(query, beta));
+
+	EXPECT_EQ(semver_range_set_min_prerelease(semver_query_get_range_at_index(query, 0), "alpha"), SEMVER_PARSE_SUCCESS);
+	EXPECT_TRUE(semver_query_matches_version(query, beta));
+
+	ASSERT_EQ(semver_query_parse(query, "~2.0"), SEMVER_QUERY_PARSE_SUCCESS);
+	EXPECT_FALSE(semver_query_matches_version(query, beta));
+
+	HSemverRange added = semver_query_add_range(query); // all versions
+	EXPECT_TRUE(semver_query_matches_version(query, stable));
+	EXPECT_FALSE(semver_query_matches_version(query, beta));
+	EXPECT_EQ(semver_range_set_min_prerelease(added, "beta"), SEMVER_PARSE_SUCCESS);
+	EXPECT_TRUE(semver_query_matches_version(query, beta));
+
+	semver_version_dispose(beta);
+	semver_version_dispose(stable);
+	semver_query_dispose(query);
+}
+
+TEST(SemverRange, RangesAndMinimumPrereleasesBeyondInlineStorage)
+{
+	HSemverQuery query = semver_query_create();
+	HSemverVersion labelled = semver_version_create_defined(3, 1, 0, "release-candidate.10", "");
+	HSemverVersion earlier = semver_version_create_defined(3, 1, 0, "release-candidate.9", "");
+
+	// more ranges than are kept inline, and a minimum prerelease too long to keep inline
+	ASSERT_EQ(semver_query_parse(query, "1.x || 2.x || >=3.0.0 <4.0.0 @release-candidate.10"), SEMVER_QUERY_PARSE_SUCCESS);
+	ASSERT_EQ(semver_query_get_range_count(query), 3u);
+	EXPECT_STREQ(semver_range_get_min_prerelease(semver_query_get_range_at_index(query, 2)), "release-candidate.10");
+	EXPECT_TRUE(semver_query_matches_version(query, labelled));
+	EXPECT_FALSE(semver_query_matches_version(query, earlier));
+
+	semver_query_erase_range_at_index(query, 0);
+	ASSERT_EQ(semver_query_get_range_count(query), 2u);
+	EXPECT_TRUE(semver_query_matches_version(query, labelled));
+
+	EXPECT_EQ(semver_range_set_min_prerelease(semver_query_get_range_at_index(query, 1), "release-candidate.9"), SEMVER_PARSE_SUCCESS);
+	EXPECT_TRUE(semver_query_matches_version(query, earlier));
+
+	HSemverQuery complement = semver_query_complement(query);
+	EXPECT_FALSE(semver_query_matches_version(complement, earlier));
+
+	semver_query_dispose(complement);
+	semver_version_dispose(labelled);
+	semver_version_dispose(earlier);
+	semver_query_dispose(query);
+}
+
+TEST(SemverRange, ReparseIntoSameQuery)
+{
+	HSemverQuery query = semver_query_create();
+	HSemverVersion candidate = semver_version_create_defined(1, 5, 0, "release-candidate.2", "");
+	HSemverVersion stable = semver_version_create_defined(3, 1, 0, "", "");
+
+	for (int i = 0; i < 100; ++i) // prereleases that do not fit inline are freed when the query is parsed again
+	{
+		ASSERT_EQ(semver_query_parse(query, ">=1.0.0-alpha.integration.build <2.0.0 @release-candidate || ^3 || ^4 @beta"), SEMVER_QUERY_PARSE_SUCCESS);
+		ASSERT_EQ(semver_query_get_range_count(query), 3u);
+		EXPECT_TRUE(semver_query_matches_version(query, candidate));
+		EXPECT_TRUE(semver_query_matches_version(query, stable));
+
+		ASSERT_EQ(semver_query_parse(query, "~1.5"), SEMVER_QUERY_PARSE_SUCCESS);
+		ASSERT_EQ(semver_query_get_range_count(query), 1u);
+		EXPECT_FALSE(semver_query_matches_version(query, candidate));
+		EXPECT_FALSE(semver_query_matches_version(query, stable));
+
+		EXPECT_EQ(semver_query_parse(query, ">=1.0.0-alpha.integration.build @01"), SEMVER_QUERY_PARSE_MIN_PRERELEASE_LEADING_ZERO_ON_NUMERIC_IDENTIFIER);
+	}
+
+	semver_version_dispose(candidate);
+	semver_version_dispose(stable);
+	semver_query_dispose(query);
+}
+
+TEST(SemverRange, ParseInputsFoundByFuzzing)
+{
+	HSemverQuery query = semver_query_create();
+	HSemverVersion version = semver_version_create_defined(5, 0, 0, "", "");
+
+	auto formatted = [&query](const char* text)
+	{
+		EXPECT_EQ(semver_query_parse(query, text), SEMVER_QUERY_PARSE_SUCCESS) << text;
+		char* str = const_cast<char*>(semver_get_query_string(query));
+		std::string result = str;
+		semver_free_string(str);
+		return result;
+	};
+
+	EXPECT_EQ(formatted("0.0.0-0-0-0"), "0.0.0-0-0-0"); // not the minimum 0.0.0-0
+	EXPECT_EQ(formatted("9007199254740991"), ">=9007199254740991.0.0");
+	EXPECT_EQ(formatted("0 || *"), ">=0.0.0 <1.0.0-0 || x"); // all versions was dropped when last
+	EXPECT_TRUE(semver_query_matches_version(query, version));
+	EXPECT_EQ(formatted("0 || * ||"), ">=0.0.0 <1.0.0-0 || x || x"); // empty alternatives match all versions, wherever they are
+	EXPECT_EQ(formatted("|| 1.2.3 ||"), "x || 1.2.3 || x");
+	EXPECT_EQ(formatted("||"), "x || x");
+	EXPECT_EQ(formatted(""), "x");
+
+	for (const char* text : { "|| 1.2.3", "1.2.3 ||", "1.2.3 || " })
+	{
+		EXPECT_EQ(semver_query_parse(query, text), SEMVER_QUERY_PARSE_SUCCESS);
+		EXPECT_TRUE(semver_query_matches_version(query, version)) << text;
+	}
+
+	EXPECT_NE(semver_query_parse(query, "0.0.0-0x||0 ="), SEMVER_QUERY_PARSE_SUCCESS); // comparator without version at the end
+	EXPECT_NE(semver_query_parse(query, "1.2.3 -"), SEMVER_QUERY_PARSE_SUCCESS);
+
+	semver_version_dispose(version);
+	semver_query_dispose(query);
+}
@@ -0,0 +1,342 @@
+// Copyright 2025 Jasper Schellingerhout. All rights reserved.
+
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "API/semver.h"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// builds a package graph for the resolver, versions are given as lists like "1.0.0, 1.1.0"
+struct Registry
+{
+	HSemverResolver resolver = semver_resolver_create();
+	std::map<std::string, HSemverVersions> packages;
+
+	~Registry()
+	{
+		semver_resolver_dispose(resolver);
+
+		for (auto& [product, versions] : packages)
+			semver_versions_dispose(versions);
+	}
+
+	void add(const char* product, const char* versions_csv)
+	{
+		HSemverVersions versions = semver_versions_from_string(versions_csv, ", ", SEMVER_ORDER_AS_GIVEN);
+		packages[product] = versions;
+		EXPECT_TRUE(semver_resolver_add_package(resolver, product, versions));
+	}
+
+	void depends(const char* product, const char* version_str, const char* dependency, const char* query_str)
+	{
+		HSemverVersions versions = packages[product];
+		HSemverQuery query = semver_query_create();
+		EXPECT_EQ(semver_query_parse(query, query_str), SEMVER_QUERY_PARSE_SUCCESS);
+
+		for (size_t i = 0; i < semver_versions_count(versions); ++i)
+		{
+			char* str = semver_get_version_string(semver_versions_get_version_at_index(versions, i));
+
+			if (strcmp(str, version_str) == 0)
+			{
+				EXPECT_TRUE(semver_resolver_add_dependency(resolver, product, i, dependency, query));
+			}
+
+			semver_free_string(str);
+		}
+
+		semver_query_dispose(query);
+	}
+
+	void require(const char* product, const char* query_str)
+	{
+		HSemverQuery query = semver_query_create();
+		EXPECT_EQ(semver_query_parse(query, query_str), SEMVER_QUERY_PARSE_SUCCESS);
+		semver_resolver_require(resolver, product, query);
+		semver_query_dispose(query); // the resolver has its own copy
+	}
+
+	std::map<std::string, std::string> solution() const
+	{
+		std::map<std::string, std::string> selected;
+
+		for (size_t i = 0; i < semver_resolver_selected_count(resolver); ++i)
+		{
+			char* str = semver_get_version_string(semver_resolver_selected_version_at_index(resolver, i));
+			selected[semver_resolver_selected_product_at_index(resolver, i)] = str;
+			semver_free_string(str);
+		}
+
+		return selected;
+	}
+
+	std::string conflict() const
+	{
+		std::string text(semver_resolver_format_conflict(resolver, nullptr, 0), '\0');
+		semver_resolver_format_conflict(resolver, text.data(), text.size() + 1);
+		return text;
+	}
+};
+
+typedef std::map<std::string, std::string> Selection;
+
+
+TEST(SemverResolver, NoConflicts)
+{
+	Registry r;
+	r.add("foo", "1.0.0");
+	r.add("bar", "1.0.0, 2.0.0");
+	r.depends("foo", "1.0.0", "bar", "^1.0.0");
+	r.require("foo", "^1.0.0");
+
+	ASSERT_TRUE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(r.solution(), (Selection{ { "foo", "1.0.0" }, { "bar", "1.0.0" } }));
+	EXPECT_EQ(r.conflict(), "");
+}
+
+TEST(SemverResolver, AvoidConflictDuringDecisionMaking)
+{
+	Registry r;
+	r.add("foo", "1.0.0, 1.1.0");
+	r.add("bar", "1.0.0, 1.1.0, 2.0.0");
+	r.depends("foo", "1.1.0", "bar", "^2.0.0");
+	r.require("foo", "^1.0.0");
+	r.require("bar", "^1.0.0");
+
+	ASSERT_TRUE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(r.solution(), (Selection{ { "foo", "1.0.0" }, { "bar", "1.1.0" } }));
+}
+
+TEST(SemverResolver, PerformConflictResolution)
+{
+	Registry r;
+	r.add("foo", "1.0.0, 2.0.0");
+	r.add("bar", "1.0.0");
+	r.depends("foo", "2.0.0", "bar", "^1.0.0");
+	r.depends("bar", "1.0.0", "foo", "^1.0.0");
+	r.require("foo", ">=1.0.0");
+
+	ASSERT_TRUE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(r.solution(), (Selection{ { "foo", "1.0.0" } }));
+	EXPECT_EQ(semver_resolver_get_selected(r.resolver, "bar"), nullptr);
+}
+
+TEST(SemverResolver, ConflictResolutionWithPartialSatisfier)
+{
+	Registry r;
+	r.add("foo", "1.0.0, 1.1.0");
+	r.add("left", "1.0.0");
+	r.add("right", "1.0.0");
+	r.add("shared", "1.0.0, 2.0.0");
+	r.add("target", "1.0.0, 2.0.0");
+	r.depends("foo", "1.1.0", "left", "^1.0.0");
+	r.depends("foo", "1.1.0", "right", "^1.0.0");
+	r.depends("left", "1.0.0", "shared", ">=1.0.0");
+	r.depends("right", "1.0.0", "shared", "<2.0.0");
+	r.depends("shared", "1.0.0", "target", "^1.0.0");
+	r.require("foo", "^1.0.0");
+	r.require("target", "^2.0.0");
+
+	ASSERT_TRUE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(r.solution(), (Selection{ { "foo", "1.0.0" }, { "target", "2.0.0" } }));
+}
+
+TEST(SemverResolver, BacktracksThroughManyVersions)
+{
+	Registry r;
+	r.add("a", "1.0.0, 2.0.0, 3.0.0, 4.0.0, 5.0.0");
+	r.add("b", "1.0.0, 2.0.0, 3.0.0, 4.0.0, 5.0.0");
+	r.add("c", "1.0.0, 2.0.0");
+
+	for (const char* v : { "2.0.0", "3.0.0", "4.0.0", "5.0.0" }) // only the oldest a works with c
+		r.depends("a", v, "c", "^2.0.0");
+
+	r.depends("b", "5.0.0", "c", "^1.0.0");
+	r.depends("b", "4.0.0", "a", "^9.0.0");
+	r.require("a", "*");
+	r.require("b", ">=5.0.0");
+
+	ASSERT_TRUE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(r.solution(), (Selection{ { "a", "1.0.0" }, { "b", "5.0.0" }, { "c", "1.0.0" } }));
+}
+
+TEST(SemverResolver, PrereleasesFollowQueryRules)
+{
+	Registry r;
+	r.add("foo", "1.0.0, 1.1.0-beta, 2.0.0-rc.1");
+	r.require("foo", "^1.0.0");
+
+	ASSERT_TRUE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(r.solution(), (Selection{ { "foo", "1.0.0" } })); // 1.1.0-beta is not matched without opting in
+
+	r.require("foo", ">=1.0.0 @beta"); // both requirements must hold
+	ASSERT_TRUE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(r.solution(), (Selection{ { "foo", "1.0.0" } }));
+
+	Registry opted;
+	opted.add("foo", "1.0.0, 1.1.0-beta, 2.0.0-rc.1");
+	opted.require("foo", "^1.0.0 @beta");
+
+	ASSERT_TRUE(semver_resolver_solve(opted.resolver));
+	EXPECT_EQ(opted.solution(), (Selection{ { "foo", "1.1.0-beta" } }));
+}
+
+TEST(SemverResolver, ReportsLinearConflict)
+{
+	Registry r;
+	r.add("foo", "1.0.0");
+	r.add("bar", "2.0.0");
+	r.add("baz", "1.0.0, 3.0.0");
+	r.depends("foo", "1.0.0", "bar", "^2.0.0");
+	r.depends("bar", "2.0.0", "baz", "^3.0.0");
+	r.require("foo", "^1.0.0");
+	r.require("baz", "^1.0.0");
+
+	EXPECT_FALSE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(semver_resolver_selected_count(r.resolver), 0);
+
+	std::string conflict = r.conflict();
+	EXPECT_NE(conflict.find("bar 2.0.0 depends on baz >=3.0.0 <4.0.0-0"), std::string::npos) << conflict;
+	EXPECT_NE(conflict.find("foo 1.0.0 depends on bar >=2.0.0 <3.0.0-0"), std::string::npos) << conflict;
+	EXPECT_NE(conflict.find("version solving failed"), std::string::npos) << conflict;
+
+	char small[8];
+	EXPECT_EQ(semver_resolver_format_conflict(r.resolver, small, sizeof(small)), conflict.size());
+	EXPECT_EQ(strlen(small), sizeof(small) - 1);
+
+	Registry shared; // versions with the same dependency are ruled out together
+	shared.add("foo", "1.0.0, 1.1.0, 1.2.0");
+	shared.add("bar", "1.0.0, 2.0.0");
+	shared.depends("foo", "1.0.0", "bar", "^2.0.0");
+	shared.depends("foo", "1.1.0", "bar", "^2.0.0");
+	shared.depends("foo", "1.2.0", "bar", "^2.0.0");
+	shared.require("foo", "^1.0.0");
+	shared.require("bar", "^1.0.0");
+
+	EXPECT_FALSE(semver_resolver_solve(shared.resolver));
+	EXPECT_NE(shared.conflict().find("every version of foo depends on bar >=2.0.0 <3.0.0-0"), std::string::npos) << shared.conflict();
+}
+
+TEST(SemverResolver, UnknownAndCyclicDependencies)
+{
+	Registry r;
+	r.add("foo", "1.0.0, 2.0.0");
+	r.add("bar", "1.0.0");
+	r.depends("foo", "2.0.0", "missing", "^1.0.0"); // never added, has no versions
+	r.depends("foo", "1.0.0", "bar", "^1.0.0");
+	r.depends("bar", "1.0.0", "foo", "^1.0.0"); // cycle
+	r.require("foo", "*");
+
+	ASSERT_TRUE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(r.solution(), (Selection{ { "foo", "1.0.0" }, { "bar", "1.0.0" } }));
+
+	EXPECT_FALSE(semver_resolver_add_package(r.resolver, "foo", nullptr)); // already added
+	HSemverQuery any = semver_query_create();
+	EXPECT_FALSE(semver_resolver_add_dependency(r.resolver, "bar", 5, "foo", any)); // no such version
+	EXPECT_FALSE(semver_resolver_add_dependency(r.resolver, "bar", 0, "foo", nullptr)); // no query
+	semver_query_dispose(any);
+
+	semver_resolver_require(r.resolver, "bar", nullptr); // requires nothing
+	ASSERT_TRUE(semver_resolver_solve(r.resolver));
+	EXPECT_EQ(r.solution(), (Selection{ { "foo", "1.0.0" }, { "bar", "1.0.0" } }));
+
+	Registry none;
+	none.add("foo", "1.0.0");
+	none.require("missing", "*");
+	EXPECT_FALSE(semver_resolver_solve(none.resolver));
+	EXPECT_NE(none.conflict().find("root depends on missing"), std::string::npos) << none.conflict();
+	EXPECT_NE(none.conflict().find("which matches no versions"), std::string::npos) << none.conflict();
+}
+
+TEST(SemverResolver, AgreesWithExhaustiveSearch)
+{
+	const char* query_strs[] = { "^1.0.0", "^2.0.0", ">=1.1.0", "<1.1.0", "*", "1.1.0 || 2.0.0" };
+	const size_t packageCount = 4;
+
+	HSemverQuery queries[6];
+
+	for (size_t q = 0; q < 6; ++q)
+	{
+		queries[q] = semver_query_create();
+		semver_query_parse(queries[q], query_strs[q]);
+	}
+
+	HSemverVersions versions = semver_versions_from_string("1.0.0, 1.1.0, 2.0.0", ", ", SEMVER_ORDER_AS_GIVEN);
+	std::mt19937 random(7);
+
+	for (int graph = 0; graph < 300; ++graph)
+	{
+		struct Edge { size_t package, version, dependency, query; };
+		std::vector<Edge> edges;
+
+		for (size_t p = 0; p < packageCount; ++p)
+			for (size_t v = 0; v < 3; ++v)
+				for (size_t d = 0; d < packageCount; ++d)
+					if (d != p && random() % 3 == 0)
+						edges.push_back({ p, v, d, random() % 6 });
+
+		size_t rootQuery = random() % 6;
+
+		HSemverResolver resolver = semver_resolver_create();
+		std::string names[packageCount] = { "p0", "p1", "p2", "p3" };
+
+		for (size_t p = 0; p < packageCount; ++p)
+			semver_resolver_add_package(resolver, names[p].c_str(), versions);
+
+		for (const Edge& e : edges)
+			semver_resolver_add_dependency(resolver, names[e.package].c_str(), e.version, names[e.dependency].c_str(), queries[e.query]);
+
+		semver_resolver_require(resolver, "p0", queries[rootQuery]);
+
+		// every assignment of a version (or none) to each package
+		bool solvable = false;
+
+		for (size_t code = 0; code < 4 * 4 * 4 * 4 && !solvable; ++code)
+		{
+			size_t selected[packageCount];
+			size_t c = code;
+
+			for (size_t p = 0; p < packageCount; ++p, c /= 4)
+				selected[p] = c % 4; // 3 is not selected
+
+			auto matches = [&](size_t p, size_t q) { return selected[p] < 3 && semver_query_matches_version(queries[q], semver_versions_get_version_at_index(versions, selected[p])); };
+
+			bool ok = matches(0, rootQuery);
+
+			for (const Edge& e : edges)
+				ok = ok && (selected[e.package] != e.version || matches(e.dependency, e.query));
+
+			solvable = ok;
+		}
+
+		BOOL solved = semver_resolver_solve(resolver);
+		EXPECT_EQ(solved != FALSE, solvable) << "graph " << graph;
+
+		if (solved)
+		{
+			for (size_t i = 0; i < semver_resolver_selected_count(resolver); ++i) // the selection meets every dependency
+			{
+				std::string product = semver_resolver_selected_product_at_index(resolver, i);
+				HSemverVersion version = semver_resolver_selected_version_at_index(resolver, i);
+				size_t p = product[1] - '0';
+
+				for (const Edge& e : edges)
+					if (e.package == p && semver_versions_get_version_at_index(versions, e.version) == version)
+					{
+						HSemverVersion dependency = semver_resolver_get_selected(resolver, names[e.dependency].c_str());
+						EXPECT_TRUE(dependency && semver_query_matches_version(queries[e.query], dependency)) << "graph " << graph;
+					}
+			}
+		}
+
+		semver_resolver_dispose(resolver);
+	}
+
+	semver_versions_dispose(versions);
+
+	for (HSemverQuery query : queries)
+		semver_query_dispose(query);
+}
@@ -3,6 +3,12 @@
 #include "pch.h"
 #include "gtest/gtest.h"
 #include "API/semver.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 TEST(SemverVersion, ParseValidVersion)
 {
@@ -601,6 +607,51 @@ TEST(SemverVersion, ParseTooLarge)
     semver_version_dispose(version);
 }
 
+TEST(SemverVersion, ParseLongNumericIdentifiers)
+{
+    HSemverVersion version = semver_version_create();
+
+    EXPECT_EQ(semver_version_parse(version, "20261016.1234567890123.20261016123045"), SEMVER_PARSE_SUCCESS);
+    EXPECT_EQ(semver_get_version_major(version), 20261016u);
+    EXPECT_EQ(semver_get_version_minor(version), 1234567890123u);
+    EXPECT_EQ(semver_get_version_patch(version), 20261016123045u);
+
+    EXPECT_EQ(semver_version_parse(version, "9007199254740991.9007199254740991.9007199254740991"), SEMVER_PARSE_SUCCESS);
+    EXPECT_EQ(semver_get_version_patch(version), SEMVER_MAX_NUMERIC_IDENTIFIER);
+
+    // over 2^64 they used to wrap around to small values
+    EXPECT_EQ(semver_version_parse(version, "18446744073709551616.0.0"), SEMVER_PARSE_MAJOR_TOO_LARGE);
+    EXPECT_EQ(semver_version_parse(version, "1.36893488147419103232.0"), SEMVER_PARSE_MINOR_TOO_LARGE);
+    EXPECT_EQ(semver_version_parse(version, "1.2.1000000000000000000000000000000000000001"), SEMVER_PARSE_PATCH_TOO_LARGE);
+
+    std::string digits = "1234567890123456";
+
+    for (size_t pos = 1; pos < digits.size(); ++pos)
+    {
+        std::string patch = digits;
+        patch[pos] = (pos % 2) ? ':' : '/'; // just past 9 and just before 0
+        EXPECT_EQ(semver_version_parse(version, ("1.2." + patch).c_str()), SEMVER_PARSE_PATCH_NOT_NUMERIC) << pos;
+    }
+
+    HSemverVersion other = semver_version_create();
+    auto compare = [&](const char* lhs, const char* rhs)
+    {
+        EXPECT_EQ(semver_version_parse(version, lhs), SEMVER_PARSE_SUCCESS);
+        EXPECT_EQ(semver_version_parse(other, rhs), SEMVER_PARSE_SUCCESS);
+        return semver_compare(version, other);
+    };
+
+    EXPECT_LT(compare("1.0.0-20261016123045", "1.0.0-20261016123046"), 0);
+    EXPECT_LT(compare("1.0.0-18446744073709551615", "1.0.0-18446744073709551616"), 0); // numeric identifiers have no maximum
+    EXPECT_LT(compare("1.0.0-99999999999999999999", "1.0.0-100000000000000000000"), 0);
+    EXPECT_GT(compare("1.0.0-36893488147419103232", "1.0.0-36893488147419103231"), 0);
+    EXPECT_EQ(compare("1.0.0-36893488147419103232.a", "1.0.0-36893488147419103232.a"), 0);
+    EXPECT_LT(compare("1.0.0-36893488147419103232", "1.0.0-3689348814741910323a"), 0); // numeric before alphanumeric
+
+    semver_version_dispose(other);
+    semver_version_dispose(version);
+}
+
 TEST(SemverVersion, ParseTooLargeSpecial)
 {
     HSemverVersion version = semver_version_create();
@@ -783,6 +834,40 @@ TEST(SemverVersion, ParseReleaseLeadingZeroOnNumeric)
     semver_version_dispose(version);
 }
 
+TEST(SemverVersion, ParseLongIdentifiers) // long segments are checked 16 characters at a time, errors at every position
+{
+    HSemverVersion version = semver_version_create();
+    const std::string identifiers = "alpha-1.Zz9.rc-B.build-11.x-y-z.a1b2c3d4e5f6a7b8c9d0";
+
+    EXPECT_EQ(semver_version_parse(version, ("1.2.3-" + identifiers + "+" + identifiers).c_str()), SEMVER_PARSE_SUCCESS);
+    EXPECT_STREQ(semver_get_version_prerelease(version), identifiers.c_str());
+    EXPECT_EQ(semver_version_parse(version, "1.2.3-0123456789abcdef.0a.0-0.0+00000000000000000.01"), SEMVER_PARSE_SUCCESS);
+
+    for (size_t pos = 1; pos < identifiers.size() - 1; ++pos)
+    {
+        std::string invalid = identifiers;
+        invalid[pos] = '/';
+        EXPECT_EQ(semver_version_parse(version, ("1.2.3-" + invalid).c_str()), SEMVER_PARSE_PRERELEASE_UNSUPPORTED_CHARACTER) << pos;
+        EXPECT_EQ(semver_version_parse(version, ("1.2.3+" + invalid).c_str()), SEMVER_PARSE_BUILD_UNSUPPORTED_CHARACTER) << pos;
+
+        std::string empty = identifiers.substr(0, pos) + ".." + identifiers.substr(pos);
+        EXPECT_EQ(semver_version_parse(version, ("1.2.3-" + empty).c_str()), SEMVER_PARSE_PRERELEASE_EMPTY_IDENTIFIER) << pos;
+        EXPECT_EQ(semver_version_parse(version, ("1.2.3+" + empty).c_str()), SEMVER_PARSE_BUILD_EMPTY_IDENTIFIER) << pos;
+
+        if (identifiers[pos - 1] == '.' || identifiers[pos] == '.')
+            continue; // the inserted identifier would follow an empty one
+
+        std::string leadingZero = identifiers.substr(0, pos) + ".01." + identifiers.substr(pos);
+        EXPECT_EQ(semver_version_parse(version, ("1.2.3-" + leadingZero).c_str()), SEMVER_PARSE_PRERELEASE_LEADING_ZERO_ON_NUMERIC_IDENTIFIER) << pos;
+        EXPECT_EQ(semver_version_parse(version, ("1.2.3+" + leadingZero).c_str()), SEMVER_PARSE_SUCCESS) << pos;
+    }
+
+    EXPECT_EQ(semver_version_parse(version, ("1.2.3-" + identifiers + ".").c_str()), SEMVER_PARSE_PRERELEASE_EMPTY_IDENTIFIER);
+    EXPECT_EQ(semver_version_parse(version, ("1.2.3+." + identifiers).c_str()), SEMVER_PARSE_BUILD_EMPTY_IDENTIFIER);
+
+    semver_version_dispose(version);
+}
+
 TEST(SemverVersion, ParseBuildEmptyIdentifier)
 {
     HSemverVersion version = semver_version_create();
@@ -1807,3 +1892,373 @@ TEST(SemverVersion, BuildSetValidFields)
     EXPECT_STREQ(semver_get_version_build(version), "21AF26D3----117B344092BD"); // - must be before + to denote prerelease
     semver_version_dispose(version);
 }
+
+TEST(SemverVersion, FormatVersionString)
+{
+    const char* test_equality[] = {
+        "2.0.0",
+        "1.0.0-alpha.beta",
+        "1.2.3-a.b.c.10.d.5",
+        "2.7.2+asdf",
+        "9007199254740991.9007199254740991.9007199254740991",
+        "x",
+        "2.3.x",
+        "1.2.155555555-beta.a.12+--this-is-fine" };
+
+    HSemverVersion version = semver_version_create();
+    char buf[64];
+
+    for (const char* v : test_equality)
+    {
+        semver_version_parse(version, v);
+
+        size_t len = semver_version_format(version, buf, sizeof(buf));
+        EXPECT_EQ(len, strlen(v));
+        EXPECT_STREQ(buf, v);
+
+        EXPECT_EQ(semver_version_format(version, nullptr, 0), len); // size query only
+    }
+
+    semver_version_parse(version, "1.2.3-alpha");
+    char small[6];
+    EXPECT_EQ(semver_version_format(version, small, sizeof(small)), 11);
+    EXPECT_STREQ(small, "1.2.3"); // truncated, but still terminated
+
+    char* str = semver_get_version_string(version);
+    EXPECT_STREQ(str, "1.2.3-alpha");
+    semver_free_string(str);
+
+    semver_version_dispose(version);
+}
+
+TEST(SemverVersion, FormatVersionBlock)
+{
+    const char versions_csv[] = "2.0.0, 1.0.0-alpha.1, 2.7.2+asdf, 1.2.3-r100, 11.222.3333-beta";
+
+    HSemverVersions versions = semver_versions_from_string(versions_csv, ", ", SEMVER_ORDER_AS_GIVEN);
+
+    size_t len = semver_versions_format(versions, ", ", nullptr, 0);
+    EXPECT_EQ(len, strlen(versions_csv));
+
+    std::string buf(len + 1, '#');
+    EXPECT_EQ(semver_versions_format(versions, ", ", buf.data(), buf.size()), len);
+    EXPECT_STREQ(buf.c_str(), versions_csv);
+
+    len = semver_versions_format(versions, nullptr, nullptr, 0); // each version \0 terminated
+    std::string multistring(len + 1, '#');
+    semver_versions_format(versions, nullptr, multistring.data(), multistring.size());
+
+    HSemverVersions versions2 = semver_versions_from_string(multistring.data(), nullptr, SEMVER_ORDER_AS_GIVEN);
+    ASSERT_EQ(semver_versions_count(versions2), semver_versions_count(versions));
+
+    for (size_t i = 0; i < semver_versions_count(versions); ++i)
+    {
+        char* str1 = semver_get_version_string(semver_versions_get_version_at_index(versions, i));
+        char* str2 = semver_get_version_string(semver_versions_get_version_at_index(versions2, i));
+        EXPECT_STREQ(str1, str2);
+        semver_free_string(str1);
+        semver_free_string(str2);
+    }
+
+    semver_versions_dispose(versions2);
+    semver_versions_dispose(versions);
+}
+
+static std::vector<std::string> versionStrings(HSemverVersions versions)
+{
+    std::vector<std::string> strs;
+
+    for (size_t i = 0; i < semver_versions_count(versions); ++i)
+    {
+        char* str = semver_get_version_string(semver_versions_get_version_at_index(versions, i));
+        strs.push_back(str);
+        semver_free_string(str);
+    }
+
+    return strs;
+}
+
+TEST(SemverVersion, StreamVersionBlock)
+{
+    const char versions_csv[] = "2.0.0, 1.0.0-alpha.1, 2.7.2+asdf, 1.2.3-r100, 11.222.3333-beta, 1.0.0-alpha.beta+exp.sha.5114f85, 0.0.1";
+
+    HSemverVersions expected = semver_versions_from_string(versions_csv, ", ", SEMVER_ORDER_ASC);
+    std::vector<std::string> expectedStrs = versionStrings(expected);
+    EXPECT_EQ(expectedStrs[2], "1.0.0-alpha.beta+exp.sha.5114f85"); // builds stay with their version when sorting
+
+    size_t len = strlen(versions_csv);
+
+    for (size_t chunkSize = 1; chunkSize <= len; ++chunkSize) // every chunk size splits tokens and separators differently
+    {
+        HSemverVersionsStream stream = semver_versions_stream_begin(", ");
+
+        for (size_t pos = 0; pos < len; pos += chunkSize)
+            semver_versions_stream_feed(stream, versions_csv + pos, std::min(chunkSize, len - pos));
+
+        HSemverVersions versions = semver_versions_stream_finish(stream, SEMVER_ORDER_ASC);
+        EXPECT_EQ(versionStrings(versions), expectedStrs) << "chunk size " << chunkSize;
+        semver_versions_dispose(versions);
+    }
+
+    semver_versions_dispose(expected);
+
+    const char versions_multistring[] = "1.2.3\0" "1.2.3-beta\0" "4.5.6+build\0" "\0" "9.9.9\0";
+    HSemverVersionsStream stream = semver_versions_stream_begin(nullptr);
+
+    for (size_t pos = 0; pos < sizeof(versions_multistring); pos += 4)
+        semver_versions_stream_feed(stream, versions_multistring + pos, std::min<size_t>(4, sizeof(versions_multistring) - pos));
+
+    HSemverVersions versions = semver_versions_stream_finish(stream, SEMVER_ORDER_DESC);
+    std::vector<std::string> descending = { "4.5.6+build", "1.2.3", "1.2.3-beta" }; // stops at the empty string
+    EXPECT_EQ(versionStrings(versions), descending);
+    semver_versions_dispose(versions);
+
+    stream = semver_versions_stream_begin(", ");
+
+    for (int i = 0; i < 1000; ++i) // grows the block several times
+    {
+        std::string version = std::to_string(i) + ".0.0, ";
+        semver_versions_stream_feed(stream, version.data(), version.size());
+    }
+
+    versions = semver_versions_stream_finish(stream, SEMVER_ORDER_DESC);
+    ASSERT_EQ(semver_versions_count(versions), 1000);
+    EXPECT_EQ(semver_get_version_major(semver_versions_get_version_at_index(versions, 0)), 999);
+    EXPECT_EQ(semver_get_version_major(semver_versions_get_version_at_index(versions, 999)), 0);
+    semver_versions_dispose(versions);
+}
+
+TEST(SemverVersion, MergeVersionBlocks)
+{
+    HSemverVersions arrays[] = {
+        semver_versions_from_string("1.0.0, 2.0.0+a, 3.0.0", ", ", SEMVER_ORDER_ASC),
+        semver_versions_from_string("4.0.0, 2.0.0+b, 2.0.0-rc", ", ", SEMVER_ORDER_DESC), // read in reverse
+        semver_versions_from_string("2.0.0+a, 0.1.0", ", ", SEMVER_ORDER_AS_GIVEN), // sorted first
+        semver_versions_create(0),
+    };
+
+    HSemverVersions merged = semver_versions_merge(arrays, 4, SEMVER_ORDER_ASC, SEMVER_DEDUP_NONE);
+    std::vector<std::string> all = { "0.1.0", "1.0.0", "2.0.0-rc", "2.0.0+a", "2.0.0+b", "2.0.0+a", "3.0.0", "4.0.0" }; // ties keep array order
+    EXPECT_EQ(versionStrings(merged), all);
+    semver_versions_dispose(merged);
+
+    merged = semver_versions_merge(arrays, 4, SEMVER_ORDER_DESC, SEMVER_DEDUP_PRECEDENCE);
+    std::vector<std::string> byPrecedence = { "4.0.0", "3.0.0", "2.0.0+a", "2.0.0-rc", "1.0.0", "0.1.0" };
+    EXPECT_EQ(versionStrings(merged), byPrecedence);
+    semver_versions_dispose(merged);
+
+    merged = semver_versions_merge(arrays, 4, SEMVER_ORDER_ASC, SEMVER_DEDUP_PRECEDENCE_AND_BUILD);
+    std::vector<std::string> byBuild = { "0.1.0", "1.0.0", "2.0.0-rc", "2.0.0+a", "2.0.0+b", "3.0.0", "4.0.0" };
+    EXPECT_EQ(versionStrings(merged), byBuild);
+    semver_versions_dispose(merged);
+
+    merged = semver_versions_merge(arrays, 4, SEMVER_ORDER_AS_GIVEN, SEMVER_DEDUP_PRECEDENCE_AND_BUILD);
+    std::vector<std::string> concatenated = { "1.0.0", "2.0.0+a", "3.0.0", "4.0.0", "2.0.0+b", "2.0.0-rc", "0.1.0" };
+    EXPECT_EQ(versionStrings(merged), concatenated);
+    semver_versions_dispose(merged);
+
+    for (HSemverVersions versions : arrays)
+        semver_versions_dispose(versions);
+
+    merged = semver_versions_merge(nullptr, 0, SEMVER_ORDER_ASC, SEMVER_DEDUP_NONE);
+    EXPECT_EQ(semver_versions_count(merged), 0);
+    semver_versions_dispose(merged);
+}
+
+TEST(SemverVersion, UniqueVersionBlock)
+{
+    const char versions_csv[] = "1.0.0+b, 2.0.0, 1.0.0+a, 1.0.0-rc, 2.0.0, 1.0.0+b, 0.1.0";
+
+    HSemverVersions unsorted = semver_versions_from_string(versions_csv, ", ", SEMVER_ORDER_AS_GIVEN);
+
+    HSemverVersions unique = semver_versions_unique(unsorted, SEMVER_DEDUP_PRECEDENCE);
+    std::vector<std::string> byPrecedence = { "1.0.0+b", "2.0.0", "1.0.0-rc", "0.1.0" };
+    EXPECT_EQ(versionStrings(unique), byPrecedence);
+    EXPECT_EQ(semver_versions_get_version_at_index(unique, 1), semver_versions_get_version_at_index(unsorted, 1)); // a view, not a copy
+    semver_versions_dispose(unique); // disposed early
+
+    unique = semver_versions_unique(unsorted, SEMVER_DEDUP_PRECEDENCE_AND_BUILD);
+    std::vector<std::string> byBuild = { "1.0.0+b", "2.0.0", "1.0.0+a", "1.0.0-rc", "0.1.0" };
+    EXPECT_EQ(versionStrings(unique), byBuild);
+
+    HSemverVersions sorted = semver_versions_from_string(versions_csv, ", ", SEMVER_ORDER_DESC);
+
+    HSemverVersions sortedUnique = semver_versions_unique(sorted, SEMVER_DEDUP_PRECEDENCE_AND_BUILD);
+    std::vector<std::string> sortedByBuild = { "2.0.0", "1.0.0+b", "1.0.0+a", "1.0.0-rc", "0.1.0" };
+    EXPECT_EQ(versionStrings(sortedUnique), sortedByBuild);
+
+    HSemverQuery query = semver_query_create();
+    semver_query_parse(query, ">=1.0.0-rc");
+    HSemverVersions matches = semver_query_match_versions(query, sortedUnique); // views of views reference the original
+    HSemverVersions uniqueMatches = semver_versions_unique(matches, SEMVER_DEDUP_PRECEDENCE);
+    std::vector<std::string> uniqueMatchStrs = { "2.0.0", "1.0.0+b", "1.0.0-rc" };
+    EXPECT_EQ(versionStrings(uniqueMatches), uniqueMatchStrs);
+    semver_query_dispose(query);
+
+    HSemverVersions compact = semver_versions_merge(&sorted, 1, SEMVER_ORDER_DESC, SEMVER_DEDUP_PRECEDENCE);
+    std::vector<std::string> compactStrs = { "2.0.0", "1.0.0+b", "1.0.0-rc", "0.1.0" };
+    EXPECT_EQ(versionStrings(compact), compactStrs);
+
+    semver_versions_dispose(compact);
+    semver_versions_dispose(sorted); // also disposes sortedUnique, matches and uniqueMatches
+    semver_versions_dispose(unsorted); // also disposes unique
+}
+
+TEST(SemverVersion, ReplicateLargeVersionBlock) // over 2 MB, so the blocks are mapped on Linux
+{
+    std::string versions_csv;
+
+    for (int minor = 0; minor < 300; ++minor)
+        for (int patch = 0; patch < 200; ++patch)
+            versions_csv += "1." + std::to_string(minor) + "." + std::to_string(patch) + (patch % 50 == 0 ? "-rc.1+b," : ",");
+
+    versions_csv.pop_back();
+
+    SemverAllocation allocation{ TRUE, semver_current_numa_node() };
+    semver_versions_set_allocation(&allocation);
+
+    HSemverVersions versions = semver_versions_from_string(versions_csv.c_str(), ",", SEMVER_ORDER_DESC);
+    ASSERT_EQ(semver_versions_count(versions), 60000);
+
+    HSemverQuery query = semver_query_create();
+    semver_query_parse(query, "~1.123.0");
+    HSemverVersions matches = semver_query_match_versions(query, versions);
+    EXPECT_EQ(semver_versions_count(matches), 196); // not the four prereleases
+
+    semver_versions_set_allocation(nullptr);
+
+    for (int node : { -1, semver_current_numa_node() })
+    {
+        HSemverVersions replica = semver_versions_replicate(versions, node);
+        EXPECT_EQ(versionStrings(replica), versionStrings(versions)); // builds too
+        EXPECT_NE(semver_versions_get_version_at_index(replica, 0), semver_versions_get_version_at_index(versions, 0)); // a copy
+
+        HSemverVersions replicaMatches = semver_query_match_versions(query, replica); // searched as sorted
+        EXPECT_EQ(versionStrings(replicaMatches), versionStrings(matches));
+        semver_versions_dispose(replica);
+    }
+
+    semver_query_dispose(query);
+    semver_versions_dispose(versions);
+
+    EXPECT_EQ(semver_versions_count(semver_versions_replicate(nullptr, 0)), 0); // the shared empty block
+}
+
+TEST(SemverVersion, StatsCountWork)
+{
+    SemverStats stats;
+    semver_stats_reset();
+
+#ifdef SEMVER_ENABLE_STATS
+    ASSERT_TRUE(semver_stats_snapshot(&stats));
+    EXPECT_EQ(stats.version_parses, 0u);
+
+    HSemverVersion long_prerelease = semver_version_create();
+    HSemverVersion short_prerelease = semver_version_create();
+    semver_version_parse(long_prerelease, "1.2.3-alpha.integration.build+b1"); // too long to keep inline
+    semver_version_parse(short_prerelease, "1.2.3-beta");
+    EXPECT_LT(semver_compare(long_prerelease, short_prerelease), 0);
+
+    semver_stats_snapshot(&stats);
+    EXPECT_EQ(stats.version_parses, 2u);
+    EXPECT_EQ(stats.prerelease_heap_spills, 1u);
+    EXPECT_EQ(stats.build_map_inserts, 1u);
+    EXPECT_EQ(stats.version_compares, 1u);
+    EXPECT_EQ(stats.prerelease_compares, 1u);
+
+    HSemverQuery query = semver_query_create();
+    semver_query_parse(query, "^1.2.3");
+    EXPECT_FALSE(semver_query_matches_version(query, long_prerelease));
+    semver_stats_snapshot(&stats);
+    EXPECT_EQ(stats.query_matches, 1u);
+
+    HSemverVersions versions = semver_versions_from_string("3.0.0,1.4.0,1.2.3", ",", SEMVER_ORDER_ASC);
+    HSemverVersions matched = semver_query_match_versions(query, versions);
+
+    semver_stats_snapshot(&stats);
+    EXPECT_GE(stats.blocks_created, 2u);
+    EXPECT_EQ(stats.block_sorts, 1u);
+    EXPECT_EQ(stats.block_queries, 1u);
+
+    std::thread worker([] // counts of exited threads are kept
+    {
+        HSemverVersion version = semver_version_create();
+
+        for (int i = 0; i < 10; ++i)
+            semver_version_parse(version, "2.0.0");
+
+        semver_version_dispose(version);
+    });
+    worker.join();
+
+    uint64_t parses = stats.version_parses;
+    semver_stats_snapshot(&stats);
+    EXPECT_EQ(stats.version_parses, parses + 10);
+
+    semver_stats_reset();
+    semver_stats_snapshot(&stats);
+    EXPECT_EQ(stats.version_parses, 0u);
+    EXPECT_EQ(stats.block_queries, 0u);
+
+    semver_versions_dispose(matched);
+    semver_versions_dispose(versions);
+    semver_query_dispose(query);
+    semver_version_dispose(long_prerelease);
+    semver_version_dispose(short_prerelease);
+#else
+    EXPECT_FALSE(semver_stats_snapshot(&stats));
+    EXPECT_EQ(stats.version_parses, 0u);
+    EXPECT_EQ(stats.query_matches, 0u);
+#endif
+}
+
+TEST(SemverVersion, TraceBulkOperations)
+{
+    std::vector<SemverTraceEvent> events;
+    semver_trace_set_callback([](void* context, const SemverTraceEvent* event)
+        { static_cast<std::vector<SemverTraceEvent>*>(context)->push_back(*event); }, &events);
+
+    HSemverVersions versions = semver_versions_from_string("3.0.0,1.4.0,1.2.3-beta", ",", SEMVER_ORDER_ASC);
+    HSemverQuery query = semver_query_create();
+    semver_query_parse(query, "^1.2.3");
+    HSemverVersions matched = semver_query_match_versions(query, versions);
+
+    semver_trace_set_callback(nullptr, nullptr);
+    semver_versions_dispose(semver_versions_from_string("1.0.0", ",", SEMVER_ORDER_ASC)); // not traced
+
+    ASSERT_EQ(events.size(), 8u);
+    SemverTracePhase phases[] = { SEMVER_TRACE_SPLIT, SEMVER_TRACE_PARSE, SEMVER_TRACE_SORT, SEMVER_TRACE_MATCH };
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        EXPECT_EQ(events[i].phase, phases[i / 2]);
+        EXPECT_EQ(events[i].begin, i % 2 == 0 ? TRUE : FALSE);
+    }
+
+    EXPECT_EQ(events[1].items, 3u); // split into three strings
+    EXPECT_EQ(events[1].bytes, 22u);
+    EXPECT_EQ(events[2].items, 3u); // parsing three
+    EXPECT_EQ(events[6].items, 3u); // matching against three
+    EXPECT_EQ(events[7].items, 1u); // 1.2.3-beta is not opted in to
+
+    const char* path = "semver_trace_test.json";
+    ASSERT_TRUE(semver_trace_chrome_begin(path));
+    semver_versions_dispose(semver_query_match_versions(query, versions));
+    semver_trace_chrome_end();
+
+    std::ifstream file(path);
+    std::stringstream json;
+    json << file.rdbuf();
+    file.close();
+    std::remove(path);
+
+    EXPECT_EQ(json.str().front(), '[');
+    EXPECT_NE(json.str().find("\"name\":\"match\",\"cat\":\"semver\",\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"ph\":\"E\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"args\":{\"items\":1,\"bytes\":0}"), std::string::npos);
+    EXPECT_EQ(json.str().substr(json.str().size() - 2), "]\n");
+
+    semver_versions_dispose(matched);
+    semver_versions_dispose(versions);
+    semver_query_dispose(query);
+}